@@ -0,0 +1,67 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "Deadline.hpp"
+#include "GameState.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace coup {
+
+struct AlphaBetaConfig {
+    int max_depth = 12;     // iterative deepening stops here...
+    int time_ms = 0;        // ...or when time runs out (0 = no limit)
+    unsigned threads = 1;   // > 1 runs lazy SMP: all threads share the table
+    size_t table_mb = 16;
+};
+
+struct AlphaBetaResult {
+    Action best{};
+    int score = 0;          // for the player to move
+    int depth = 0;          // last fully searched depth
+    uint64_t nodes = 0;
+
+    // True when the score is a forced win or loss rather than an estimate.
+    bool proven() const;
+};
+
+// Iterative-deepening alpha-beta for positions with two players left, where
+// the game is zero-sum. Scores are for the player to move; a player may move
+// several times in a row (bribe, spy_on, undo), so the sign only flips when
+// the turn changes hands. Moves are tried best-first: the table's move, then
+// coups, then tax/invest. The transposition table is lock-free (each slot
+// stores key ^ data next to data, so a torn write just fails to match) and
+// is kept between searches.
+class AlphaBeta {
+public:
+    static const int WIN = 30000;
+
+    explicit AlphaBeta(const AlphaBetaConfig& config = {});
+    ~AlphaBeta();
+
+    // Throws unless exactly two players are alive. Stops at the deadline or
+    // after time_ms, whichever comes first, with the last finished depth.
+    AlphaBetaResult search(const GameState& state, Deadline deadline = {});
+
+    void clear_table();
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check{0};  // key ^ data
+        std::atomic<uint64_t> data{0};
+    };
+    class Worker;
+
+    bool probe(uint64_t key, uint64_t& data) const;
+    void store(uint64_t key, uint64_t data);
+
+    AlphaBetaConfig config;
+    std::unique_ptr<Entry[]> table;
+    size_t mask = 0;
+    std::atomic<bool> stop{false};
+};
+
+}
@@ -0,0 +1,65 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+#include "Rollout.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace coup {
+
+// What one seat believes about the others: for every seat, a joint
+// probability table over (role, coins). Roles start uniform (they are dealt
+// independently) and coins start at the public starting counts. Each
+// observed action moves the coins of the seats it touches by the amount
+// each role would gain or pay, and zeroes the cells under which it would
+// have been illegal or would have had another public outcome - so an
+// invest leaves only Baron, an undo rules out Governor for its target and
+// surviving a coup leaves only a General with 5+ coins. Actions are taken
+// as equally likely under every hypothesis that allows them.
+// Coins are hidden by default (the viewer sees only its own, and a target's
+// after its own spy_on). With visible_coins every seat's count is read from
+// the table, so amounts give roles away too: a 3-coin tax is a Governor's
+// and a coin back for a sanction is a Baron's.
+// The tables are fixed-size arrays; observe() does not allocate and touches
+// only the one or two seats an action involves.
+class BeliefTracker {
+public:
+    static const int COIN_BINS = 24;  // the last bin also holds anything above
+    using Table = std::array<std::array<float, COIN_BINS>, NUM_ROLES>;
+
+    BeliefTracker() = default;
+    BeliefTracker(const GameState& start, int viewer, bool visible_coins = false);
+
+    int viewer() const { return seat; }
+
+    // `after` is the true state after the action; only its public fields,
+    // the viewer's own seat and (if visible) coin counts are read.
+    void observe(const Action& action, const GameState& after);
+
+    float role_probability(int seat, Role role) const;
+    float coin_probability(int seat, int coins) const;
+    float expected_coins(int seat) const;
+    Role likely_role(int seat) const;
+    const Table& table(int seat) const { return tables[seat]; }
+
+    // `actual` with every other seat's role and coins drawn from its table.
+    GameState determinize(const GameState& actual, FastRng& rng) const;
+
+    // One line for a hint, e.g. "Baron 71%, Governor 12% - about 4 coins".
+    std::string summary(int seat) const;
+
+private:
+    void reveal(int seat, Role role, int coins);
+    void reveal_coins(int seat, int coins);
+
+    int seat = 0;
+    uint8_t num_seats = 0;
+    bool coins_visible = false;
+    std::array<int16_t, MAX_PLAYERS> known{};  // exact coins if seen, else -1
+    std::array<Table, MAX_PLAYERS> tables{};
+};
+
+}
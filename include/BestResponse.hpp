@@ -0,0 +1,41 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "Policy.hpp"
+#include "Tablebase.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace coup {
+
+struct BestResponseConfig {
+    int depth = 8;                         // plies searched from each start
+    unsigned threads = 1;
+    size_t table_mb = 64;                  // memo shared by all threads
+    const Tablebase* tablebase = nullptr;  // scores horizon positions it knows
+};
+
+struct ExploitabilityResult {
+    double value = 0;                // mean over role deals and both seats
+    double by_seat[2] = {0, 0};      // responder moving first / second
+    uint64_t nodes = 0;
+};
+
+// Value (+1 win, -1 loss) for `responder` of the best response to `policy`,
+// which plays every other seat, from a two-player position. Expectimax:
+// the responder maximizes, the policy's moves are averaged by their
+// probabilities. Positions still open after `depth` plies score 0 unless
+// the tablebase solves them. The responder sees roles and coins, so this is
+// an upper bound on what a real opponent could win.
+double best_response_value(const Policy& policy, const GameState& start, int responder,
+                           const BestResponseConfig& config = {});
+
+// Exploitability of a policy in two-player games: the best response's value
+// averaged over all 36 role deals and both seats. Zero-sum and symmetric, so
+// an equilibrium policy scores at most 0 and higher is more exploitable.
+// Deals run in parallel and share one memo keyed by (state hash, responder,
+// plies left).
+ExploitabilityResult exploitability(const Policy& policy, const BestResponseConfig& config = {});
+
+}
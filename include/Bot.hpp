@@ -0,0 +1,50 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "Deadline.hpp"
+#include "GameState.hpp"
+
+#include <string>
+
+namespace coup {
+
+class Game;
+
+// A computer player. choose() is called with the bot's own seat to move and
+// must return one of state's legal actions.
+class Bot {
+public:
+    virtual ~Bot() = default;
+    virtual std::string name() const = 0;
+    virtual Action choose(const GameState& state) = 0;
+
+    // Anytime version of choose(): returns no later than the deadline (plus
+    // the time to stop the search and pick a move), with the best move found
+    // so far. Bots that decide in well under a millisecond just choose().
+    virtual Action decide(const GameState& state, Deadline /*deadline*/) { return choose(state); }
+
+    // Optional observation hooks for bots that track hidden information:
+    // the table at the start (the bot sits at seat), then every action
+    // played by anyone with the state after it.
+    virtual void on_game_start(const GameState& /*start*/, int /*seat*/) {}
+    virtual void on_action(const Action& /*action*/, const GameState& /*after*/) {}
+
+private:
+    // How far play_turn has fed this bot the history of a Game
+    friend Action play_turn(Bot& bot, Game& game, Deadline deadline);
+    const Game* followed = nullptr;
+    int followed_seat = -1;
+    size_t seen = 0;
+    GameState replayed;
+};
+
+// Lets a bot take the current turn of a running Game: converts the game to a
+// GameState, asks the bot, and performs the action through the Player API.
+// Before deciding, the bot gets on_game_start() for its seat and then
+// on_action() for every action in game.history() it has not seen yet, so
+// pondering and hidden-information bots follow the table between turns.
+// A game set up by hand (coins added outside the actions) does not replay
+// from its history; the bot then starts afresh at the current position.
+Action play_turn(Bot& bot, Game& game, Deadline deadline = {});
+
+}
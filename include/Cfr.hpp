@@ -0,0 +1,78 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "Policy.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace coup {
+
+// Abstraction of a two-player position as seen by the player to move: own
+// role, own and opponent coins in buckets (cut at the 3/4/5/7/10 thresholds
+// of the rules), the flags that change what can be played, and the
+// opponent's last action (the public history that matters). With two
+// players an action is identified by its type alone.
+const int CFR_COIN_BUCKETS = 7;
+const uint32_t CFR_INFOSETS = NUM_ROLES * CFR_COIN_BUCKETS * CFR_COIN_BUCKETS * 32 * (NUM_ACTION_TYPES + 1);
+
+// Throws unless exactly two players are alive.
+uint32_t cfr_infoset(const GameState& state);
+
+struct CfrConfig {
+    unsigned threads = 1;
+    int horizon = 6;            // plies explored per traversal; a rollout scores the rest
+    int max_start_plies = 60;   // traversals start after 0..max_start_plies rollout plies
+    uint64_t seed = 1;
+};
+
+// Average strategy of a solver, or one loaded from a file. Positions with
+// more than two players alive get a uniform distribution.
+class CfrPolicy : public Policy {
+public:
+    explicit CfrPolicy(std::vector<float> probs);
+    explicit CfrPolicy(const std::string& path);  // throws if invalid
+
+    void distribution(const GameState& state, const ActionList& legal, float* probs) const override;
+    void save(const std::string& path) const;
+
+private:
+    std::vector<float> table;  // CFR_INFOSETS x NUM_ACTION_TYPES
+};
+
+// Monte Carlo CFR with external sampling and CFR+ updates (regrets clipped at
+// zero, strategy sums weighted by iteration). Each iteration deals random
+// roles, plays a random number of rollout plies to pick a start position,
+// then runs one traversal for each player. Threads share the flat regret
+// and strategy tables through relaxed atomics.
+class CfrSolver {
+public:
+    explicit CfrSolver(const CfrConfig& config = {});
+
+    // Runs more iterations; reports regret_bound() every report_every.
+    void run(uint64_t iterations, std::ostream* report = nullptr, uint64_t report_every = 0);
+
+    uint64_t iterations() const { return done.load(); }
+
+    // Largest positive regret of every information set, summed and divided
+    // by the iterations: the usual CFR bound on the average strategy's
+    // exploitability in the abstract game (an estimate, as regrets are sampled).
+    double regret_bound() const;
+
+    CfrPolicy policy() const;
+
+private:
+    float traverse(const GameState& state, int traverser, int depth, uint64_t weight, FastRng& rng);
+    void regret_matching(uint32_t infoset, const ActionList& legal, float* probs) const;
+
+    CfrConfig config;
+    std::unique_ptr<std::atomic<float>[]> regrets;
+    std::unique_ptr<std::atomic<float>[]> strategy_sum;
+    std::atomic<uint64_t> done{0};
+};
+
+}
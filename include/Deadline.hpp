@@ -0,0 +1,57 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace coup {
+
+// When a decision has to be ready: a point in time, a flag that another
+// thread can set to stop the search early, both, or neither. Searches call
+// expired() from their loops and return the best move found so far.
+class Deadline {
+public:
+    using clock = std::chrono::steady_clock;
+
+    Deadline() = default;  // never expires unless cancelled
+
+    static Deadline after(std::chrono::milliseconds budget) {
+        Deadline d;
+        d.when = clock::now() + budget;
+        return d;
+    }
+
+    // A copy that also expires `budget` from now, if that is sooner.
+    Deadline within(std::chrono::milliseconds budget) const {
+        Deadline d = *this;
+        d.when = std::min(when, clock::now() + budget);
+        return d;
+    }
+
+    // A copy that expires once `fraction` of the time left is used up (the
+    // same deadline if there is no time limit).
+    Deadline share(double fraction) const {
+        if (!has_time_limit()) return *this;
+        Deadline d = *this;
+        auto now = clock::now();
+        if (when > now) d.when = now + std::chrono::duration_cast<clock::duration>((when - now) * fraction);
+        return d;
+    }
+
+    // Also expires as soon as flag is set. The flag must outlive the search.
+    Deadline& cancel_on(const std::atomic<bool>& flag) {
+        stop = &flag;
+        return *this;
+    }
+
+    bool has_time_limit() const { return when != clock::time_point::max(); }
+    bool cancelled() const { return stop && stop->load(std::memory_order_relaxed); }
+    bool expired() const { return cancelled() || (has_time_limit() && clock::now() >= when); }
+
+private:
+    clock::time_point when = clock::time_point::max();
+    const std::atomic<bool>* stop = nullptr;
+};
+
+}
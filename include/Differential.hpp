@@ -0,0 +1,44 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace coup {
+
+// Lockstep testing of the fast engine (GameState) against the reference
+// classes (Game/Player): both play the same action stream and their state
+// hashes are compared after every action.
+
+struct Divergence {
+    uint64_t seed = 0;
+    std::vector<Role> roles;
+    std::vector<Action> actions;  // the last action is where the engines part ways
+    std::string reason;
+};
+
+struct LockstepResult {
+    uint64_t actions = 0;  // actions checked
+    std::optional<Divergence> divergence;
+};
+
+// Plays the game derived from seed for at most max_actions actions. Most are
+// drawn from the engine's legal moves; some are random probes which both
+// sides must agree to reject.
+LockstepResult run_lockstep(uint64_t seed, int max_actions);
+
+// Replays a fixed action list and returns the first mismatch, or "" if the
+// engines agree throughout. failed_at receives the index of that action.
+std::string replay_lockstep(const std::vector<Role>& roles, const std::vector<Action>& actions,
+                            size_t* failed_at = nullptr);
+
+// Shrinks the action list while the replay still diverges.
+Divergence minimize(const Divergence& divergence);
+
+std::string describe(const Divergence& divergence);
+
+}
@@ -0,0 +1,51 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "Rollout.hpp"
+
+#include <array>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace coup {
+
+const int NUM_FEATURES = 18;
+const int EVAL_BATCH = 64;
+
+// Static evaluation: a linear score per seat over hand-made features
+// (coins and thresholds, role, flags, seats until its turn, coup threats),
+// turned into win chances with a softmax over the seats still alive.
+// Batches are laid out feature-major (one array per feature, one lane per
+// seat of each state), so the scoring loop is a plain multiply-add over
+// lanes that the compiler vectorizes.
+class LinearEvaluator {
+public:
+    LinearEvaluator() = default;                   // all zero: even chances
+    explicit LinearEvaluator(const std::string& path);  // throws if invalid
+
+    // Features of `seat` in state, written to out[0..NUM_FEATURES).
+    static void features(const GameState& state, int seat, float* out);
+
+    Rewards evaluate(const GameState& state) const;
+    void evaluate_batch(const GameState* states, int count, Rewards* out) const;  // count <= EVAL_BATCH
+
+    std::array<float, NUM_FEATURES> weights{};
+
+    void save(const std::string& path) const;
+};
+
+struct EvalTrainConfig {
+    int games = 5000;
+    unsigned threads = 1;   // self-play games are generated in parallel
+    int epochs = 4;
+    float learning_rate = 0.02f;
+    uint64_t seed = 1;
+};
+
+// Plays self-play games between the heuristic rollout policies at random
+// table sizes and roles, then fits the weights to who won (softmax
+// regression, SGD). Reports the mean log loss after each epoch.
+LinearEvaluator train_evaluator(const EvalTrainConfig& config, std::ostream* report = nullptr);
+
+}
@@ -0,0 +1,30 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace coup {
+
+// Thrown when a game invariant is broken. Deliberately not a runtime_error,
+// so it can never be mistaken for an ordinary rule rejection.
+class InvariantViolation : public std::logic_error {
+public:
+    explicit InvariantViolation(const std::string& what) : std::logic_error(what) {}
+};
+
+// Interprets the bytes as a table setup followed by (actor, action, target)
+// triples and plays them against Game/Player, checking invariants after every
+// step. Once the input runs out the game is played to the end and the winner
+// is checked. Throws InvariantViolation on the first broken invariant.
+void fuzz_one_input(const uint8_t* data, size_t size);
+
+// Play-outs given up so far in this process (see Harness::play_out): games
+// kept going only by Generals blocking coups. Drivers fail a campaign where
+// more than MAX_ABANDONED_PERCENT of the inputs end this way.
+uint64_t abandoned_playouts();
+const int MAX_ABANDONED_PERCENT = 5;
+
+}
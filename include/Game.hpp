@@ -1,6 +1,8 @@
 //Email:adhamhamoudy3@gmail.com
 #pragma once
 
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 #include <stdexcept>
@@ -8,22 +10,48 @@
 namespace coup {
 
 class Player;  // forward declaration
+struct Action;  // GameState.hpp; not included so the GUI's own GameState stays unambiguous
+enum class ActionType : uint8_t;
 
 class Game {
 private:
     std::vector<Player*> active_players;
+    std::vector<Player*> seat_order;  // every player ever added, in seat order
     size_t current_turn_index = 0;
+    std::vector<Action> log;  // every action played, in order
+
+    void end_turn(Player* player);
+    void record(ActionType type, const Player* actor, const Player* target);
 
 public:
     Game();
+    ~Game();
     void add_player(Player* player);
     std::vector<std::string> players() const;
+    const std::vector<Player*>& player_list() const;
     std::string turn() const;
+    size_t turn_index() const;
     std::string winner() const;
     void eliminate(Player* player);
     void advance_turn();
     void coup(Player* attacker, Player* target);
 
+    // Seats as the fast engine numbers them: players in the order they
+    // joined, eliminated ones included.
+    const std::vector<Player*>& seats() const;
+
+    // Every action played so far as engine actions on seats(), recorded by
+    // the Player actions and apply_batch(); its size is the ply count.
+    const std::vector<Action>& history() const;
+
+    // Applies engine actions (seat numbers as in seats()) that are known to
+    // be legal, e.g. from a verified replay. Roles are looked up once per
+    // batch and the rules are not re-checked: no name compares, no casts,
+    // and the Spy's stderr line is not printed. Only the turn and the seat
+    // numbers are checked; an action out of turn throws, and the actions
+    // before it stay applied.
+    void apply_batch(std::span<const Action> actions);
+
     // friend access to Player
     friend class Player;
 };
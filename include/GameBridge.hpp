@@ -0,0 +1,30 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+
+#include <string>
+#include <vector>
+
+namespace coup {
+
+class Game;
+class Player;
+
+// Conversions between the reference classes (Game/Player) and GameState.
+
+// Allocates a player of the given role; the caller owns it.
+Player* create_player(Game& game, Role role, const std::string& name);
+
+// Seats are the game's active players in turn order.
+GameState state_from_game(const Game& game);
+
+// Seats are the given players, eliminated ones included, so seat numbers
+// stay stable for the whole game. The ply is the length of game.history().
+GameState state_from_players(const Game& game, const std::vector<Player*>& seats);
+
+// Performs an engine action through the Player API, seat i being seats[i].
+// Rule violations surface as the usual runtime_error.
+void perform(const Action& action, const std::vector<Player*>& seats);
+
+}
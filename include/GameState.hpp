@@ -0,0 +1,101 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace coup {
+
+// Fast engine: a compact value-type copy of the rules in Game/Player.
+// No heap, no strings, no exceptions - roles are enums, per-seat data is
+// kept in parallel arrays and flags in bitmasks, so a state can be copied
+// and hashed cheaply by search code. Game/Player stay the reference rules.
+
+enum class Role : uint8_t { Governor, Spy, Baron, General, Judge, Merchant };
+const int NUM_ROLES = 6;
+
+enum class ActionType : uint8_t {
+    Gather, Tax, Bribe, Invest, Skip,      // no target
+    Arrest, Sanction, Coup, SpyOn, Undo    // need a target seat
+};
+const int NUM_ACTION_TYPES = 10;
+
+const int MAX_PLAYERS = 6;
+const int MAX_ACTIONS = 32;
+const uint8_t NO_SEAT = 0xFF;
+const uint8_t NO_ACTION = 0xFF;
+
+// Bump whenever is_legal()/apply() change, so saved tables and replays made
+// under older rules are rejected.
+const uint32_t RULES_VERSION = 1;
+
+struct Action {
+    ActionType type = ActionType::Gather;
+    uint8_t actor = 0;
+    uint8_t target = NO_SEAT;
+
+    bool operator==(const Action&) const = default;
+};
+
+std::string role_name(Role role);
+Role role_from_name(const std::string& name);
+const char* action_name(ActionType type);
+bool needs_target(ActionType type);
+std::string describe(const Action& action);
+
+// Fixed-capacity move list, so generating moves never allocates.
+class ActionList {
+    std::array<Action, MAX_ACTIONS> items;
+    int count = 0;
+
+public:
+    void clear() { count = 0; }
+    void push_back(const Action& action) { items[count++] = action; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Action& operator[](int i) const { return items[i]; }
+    const Action* begin() const { return items.data(); }
+    const Action* end() const { return items.data() + count; }
+};
+
+struct GameState {
+    uint8_t num_seats = 0;
+    uint8_t to_move = 0;
+    uint8_t alive = 0;       // one bit per seat
+    uint8_t arrested = 0;    // arrested or spied on since their last turn
+    uint8_t sanctioned = 0;
+    uint8_t bribed = 0;      // a bribe is still owed an extra action
+    uint16_t ply = 0;
+    std::array<uint8_t, MAX_PLAYERS> coins{};
+    std::array<Role, MAX_PLAYERS> roles{};
+    std::array<uint8_t, MAX_PLAYERS> last_target{};  // seat or NO_SEAT
+    std::array<uint8_t, MAX_PLAYERS> last_action{};  // ActionType or NO_ACTION
+
+    // Fresh table, seat 0 to move. Throws for fewer than 2 or more than 6 roles.
+    static GameState initial(const std::vector<Role>& roles);
+
+    bool is_alive(int seat) const { return (alive >> seat) & 1; }
+    int alive_count() const;
+    bool is_terminal() const { return alive_count() <= 1; }
+    int winner() const;  // seat, or -1 while the game is running
+
+    // Only the player to move acts. Spy and Governor abilities are modelled
+    // as free actions on their own turn (as in the GUI), and Skip is the
+    // GUI's "turn skipped due to sanction".
+    void legal_actions(ActionList& out) const;
+    bool is_legal(const Action& action) const;
+    void apply(const Action& action);  // action must be legal
+
+    // Hash of everything the rules can observe; eliminated seats and the
+    // ply counter do not contribute.
+    uint64_t hash() const;
+    std::string describe() const;
+
+private:
+    void end_turn(int seat);
+    void advance_turn();
+};
+
+}
@@ -0,0 +1,50 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "Bot.hpp"
+#include "Rollout.hpp"
+
+#include <array>
+#include <string>
+#include <utility>
+
+namespace coup {
+
+// Weights of a rule-based player. Every legal action gets
+//   action_weight[type]
+//   + per_target_coin * target's coins + threat_bonus if the target can coup
+//   - per_coin_spent * coins the action costs
+// and the best score is played; ties go to the earlier legal action. With
+// probability epsilon a random legal action is played instead.
+struct HeuristicParams {
+    std::array<float, NUM_ACTION_TYPES> action_weight{};
+    float per_target_coin = 0;
+    float threat_bonus = 0;
+    float per_coin_spent = 0;
+    float epsilon = 0;
+
+    static HeuristicParams greedy();      // coups as soon as it can
+    static HeuristicParams economic();    // invests/taxes, coups only when forced
+    static HeuristicParams aggressive();  // arrests and sanctions the richest
+};
+
+// Scores the legal actions from the move generator: no allocation, no
+// Player calls, well under a microsecond per decision. The game must not
+// be over.
+Action heuristic_action(const GameState& state, const HeuristicParams& params, FastRng& rng);
+
+class HeuristicBot : public Bot {
+public:
+    HeuristicBot(std::string name, const HeuristicParams& params, uint64_t seed = 1)
+        : bot_name(std::move(name)), params(params), rng(seed) {}
+
+    std::string name() const override { return bot_name; }
+    Action choose(const GameState& state) override;
+
+private:
+    std::string bot_name;
+    HeuristicParams params;
+    FastRng rng;
+};
+
+}
@@ -0,0 +1,53 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "BeliefTracker.hpp"
+#include "MctsBot.hpp"
+#include "Observation.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace coup {
+
+// Information-set MCTS (single observer). Opponents' roles and coins are
+// hidden, so every iteration searches a different determinization drawn
+// from the bot's Observation, and one tree collects statistics over all of
+// them: a child's exploration term counts how often its action was
+// available, not how often its parent was visited.
+// Feed the bot on_game_start() and on_action() so it sees only what a human
+// at the table would; play_turn() does this from the Game's history. Without
+// them it starts observing from the state passed to choose(), and treats
+// that state's coins as known - so do not call choose() mid-game on a bot
+// that has not watched the game from the deal.
+// The bot also keeps a BeliefTracker over the same events, for callers that
+// want role odds rather than samples (hints, logging).
+// Uses MctsConfig; threads always run one tree each (root parallelization),
+// so parallelism and virtual_loss are ignored.
+class IsmctsBot : public Bot {
+public:
+    explicit IsmctsBot(const MctsConfig& config = {});
+
+    std::string name() const override { return "ismcts"; }
+    Action choose(const GameState& state) override;
+    Action decide(const GameState& state, Deadline deadline) override;
+    void on_game_start(const GameState& start, int seat) override;
+    void on_action(const Action& action, const GameState& after) override;
+
+    const Observation& observation() const { return obs; }
+    const BeliefTracker& beliefs() const { return belief; }
+    const std::vector<std::pair<Action, uint64_t>>& last_visits() const { return visits; }
+    uint64_t last_playouts() const { return playouts; }
+
+private:
+    MctsConfig config;
+    Observation obs;
+    BeliefTracker belief;
+    bool observing = false;
+    uint64_t playouts = 0;
+    uint64_t searches = 0;
+    std::vector<std::pair<Action, uint64_t>> visits;
+};
+
+}
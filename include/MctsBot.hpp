@@ -0,0 +1,115 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "AlphaBeta.hpp"
+#include "Bot.hpp"
+#include "Evaluator.hpp"
+#include "OpeningBook.hpp"
+#include "Rollout.hpp"
+#include "Tablebase.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace coup {
+
+enum class Parallelism {
+    Root,  // one tree per thread, root visit counts merged at the end
+    Tree   // all threads search one shared tree (virtual loss, lock-free expansion)
+};
+
+struct MctsConfig {
+    int iterations = 20000;     // total over all threads; 0 = time budget only
+    int time_ms = 0;            // 0 = iteration budget only (or the decide() deadline)
+    unsigned threads = 1;
+    Parallelism parallelism = Parallelism::Root;
+    int virtual_loss = 1;       // tree mode: visits added on the way down
+    size_t max_nodes = 1 << 20; // hard cap on search nodes (split between root-mode trees)
+    bool reuse_tree = true;     // root mode: keep the subtree of the position reached
+    bool ponder = false;        // root mode with reuse: search on during other seats' turns
+    double exploration = 1.4;
+    RolloutPolicy rollout = RolloutPolicy::Heuristic;
+    int max_rollout_plies = 300;  // longer rollouts are scored as a draw
+    uint64_t seed = 0;          // 0 = seed from std::random_device
+    int endgame_depth = 12;     // alpha-beta depth with two players left (0 = off)
+    const Tablebase* tablebase = nullptr;  // checked before alpha-beta if set
+    const OpeningBook* book = nullptr;     // played without searching while it has the position
+    const LinearEvaluator* evaluator = nullptr;  // root mode: score leaves in batches instead of rollouts
+};
+
+class SearchTree;
+
+// UCT search over the fast engine. Rewards are per seat (1 for the winner),
+// and every node is scored from the point of view of the seat that moved
+// into it, so the same search works for any role and table size.
+// Root mode scales by running independent trees; tree mode shares one tree
+// whose counters are atomics, and spreads threads across branches with
+// virtual loss.
+// Memory is capped by max_nodes. Root-mode trees recycle their least-visited
+// subtrees when full and are kept between decisions: the next choose()
+// continues from the subtree of the position reached, if it is in the tree.
+// With two players left, the tablebase (if any) and then an alpha-beta
+// search run first, and a proven winning move is played outright.
+// With an evaluator, root-mode trees descend EVAL_BATCH times (visits added
+// on the way down) and score all the leaves in one evaluator call.
+// With ponder set, the trees keep searching on background threads after
+// each decision, from the position after the bot's move; on_action()
+// re-roots them as the other seats play, and the next decision stops the
+// pondering and continues from the subtree it grew.
+class MctsBot : public Bot {
+public:
+    explicit MctsBot(const MctsConfig& config = {});
+    ~MctsBot() override;
+
+    std::string name() const override { return "mcts"; }
+    Action choose(const GameState& state) override;
+    // Searches until the deadline, time_ms or the iteration budget runs
+    // out, whichever is first (iterations = 0: no budget).
+    Action decide(const GameState& state, Deadline deadline) override;
+    void on_game_start(const GameState& start, int seat) override;
+    void on_action(const Action& action, const GameState& after) override;
+
+    // Searches from state on background threads until stopped (root mode
+    // with tree reuse only). Other calls stop pondering first, except the
+    // accessors below: call stop_pondering() before reading them.
+    void ponder(const GameState& state);
+    void stop_pondering();
+    bool pondering() const { return ponder_thread.joinable(); }
+
+    // Root visit counts after the last search, summed over all threads
+    // (root mode includes visits kept from earlier searches).
+    const std::vector<std::pair<Action, uint64_t>>& last_visits() const { return visits; }
+    // Playouts run by the last search.
+    uint64_t last_playouts() const { return playouts; }
+    // Playouts run while pondering before the last search.
+    uint64_t last_pondered() const { return pondered; }
+    // Nodes held by the root-mode trees.
+    size_t nodes_in_use() const;
+    // Result of the last endgame search (depth 0 if none ran).
+    const AlphaBetaResult& last_endgame() const { return endgame_result; }
+
+private:
+    Action search(const GameState& state, Deadline deadline);
+    void prepare_trees(const GameState& state);
+    uint64_t run_trees(int iterations, const Deadline& deadline);
+    void search_root_parallel(const GameState& state, int iterations, const Deadline& deadline);
+    void search_tree_parallel(const GameState& state, int iterations, const Deadline& deadline);
+
+    MctsConfig config;
+    uint64_t playouts = 0;
+    uint64_t pondered = 0;
+    uint64_t searches = 0;
+    std::vector<std::pair<Action, uint64_t>> visits;
+    std::vector<std::unique_ptr<SearchTree>> trees;
+    std::unique_ptr<AlphaBeta> endgame;
+    AlphaBetaResult endgame_result;
+    std::thread ponder_thread;
+    std::atomic<bool> ponder_stop{false};
+    uint64_t ponder_playouts = 0;  // written by the ponder thread
+};
+
+}
@@ -14,7 +14,7 @@ public:
 
     // Override arrest behavior
     void on_arrested_by(Player& by) override;
-    void validate_turn() const override;
+    void start_turn() override;
 
 };
 
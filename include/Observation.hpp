@@ -0,0 +1,68 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+#include "Rollout.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace coup {
+
+// What one seat knows about a game: its own role, the public action history
+// and who is still alive, plus the coins it saw with its own spy_on.
+// Opponents' roles and coins are hidden (as in the GUI), so the observation
+// keeps a set of particles - full GameStates whose hidden roles are
+// consistent with everything seen so far - and builds determinizations for
+// search from random ones.
+class Observation {
+public:
+    static const int PARTICLES = 64;
+
+    Observation() = default;
+
+    // Starts observing a fresh table. Only the viewer's own role is read
+    // from start; every other seat is treated as unknown.
+    Observation(const GameState& start, int viewer, uint64_t seed = 1);
+
+    int viewer() const { return seat; }
+    size_t history_size() const { return history.size(); }
+    // Ply of the latest recorded state.
+    uint16_t ply() const { return static_cast<uint16_t>(start_public.ply + history.size()); }
+
+    // Records a public action. `after` is the true state after it; only the
+    // public outcome (who is alive) and, for the viewer's own spy_on, the
+    // target's coins are read from it.
+    void record(const Action& action, const GameState& after);
+
+    // A determinization: `actual` with every opponent's role, coins and last
+    // action replaced by those of a random particle. Only public fields and
+    // the viewer's own seat are kept from `actual`, so the true hidden values
+    // (including a last action that only a Governor's tax would leave unset)
+    // never reach the search.
+    GameState determinize(const GameState& actual, FastRng& rng) const;
+
+    // Bitmask of roles still possible for a seat (bit r = Role r).
+    uint8_t possible_roles(int seat) const;
+
+private:
+    struct Step {
+        Action action;
+        uint8_t alive_after;
+        int16_t revealed_coins;  // -1 unless the viewer spied on the target
+    };
+
+    uint8_t evidence_roles(int seat) const;
+    bool consistent(const GameState& state, const Step& step) const;
+    bool replay(GameState& state) const;
+    void refill();
+
+    int seat = 0;
+    GameState start_public;   // start with hidden roles left at Governor
+    Role own_role = Role::Governor;
+    std::vector<Step> history;
+    std::vector<GameState> particles;
+    FastRng rng{1};
+};
+
+}
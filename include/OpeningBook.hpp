@@ -0,0 +1,67 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace coup {
+
+// Opening book: the move to play in positions from the first few plies,
+// searched offline. A position is keyed by what its mover knows - the
+// public state plus its own role - so one entry serves every deal of the
+// other seats' roles.
+//
+// File: a 64-byte header, then entries sorted by key (16 bytes each), so
+// a lookup is a binary search over the mapped file.
+
+struct OpeningBookConfig {
+    int num_seats = 6;
+    int plies = 12;            // positions before this ply are covered
+    int sample_games = 4000;   // openings played to collect positions
+    int min_hits = 2;          // positions seen less often are left out
+    int deals = 8;             // hidden-role deals searched per position
+    int iterations = 4000;     // MCTS iterations per deal
+    unsigned threads = 1;      // positions are searched in parallel
+    uint64_t seed = 1;
+};
+
+// Collects the positions reached by openings between the heuristic rollout
+// policies, searches each with MCTS over several random deals of the
+// hidden roles (root visits summed), and writes the book to path. Returns
+// the number of entries.
+uint64_t build_opening_book(const std::string& path, const OpeningBookConfig& config,
+                            std::ostream* progress = nullptr);
+
+// A book file, mapped read-only.
+class OpeningBook {
+public:
+    explicit OpeningBook(const std::string& path);  // throws if invalid
+    ~OpeningBook();
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    // Key of a position: its hash with every other seat's role hidden.
+    static uint64_t key(const GameState& state);
+
+    uint64_t size() const { return count; }
+    int plies() const { return max_ply; }
+
+    // The book move, if the position is in the book and the move is legal.
+    bool lookup(const GameState& state, Action& out) const;
+
+private:
+    void unmap();
+
+    int fd = -1;
+    void* map = nullptr;
+    size_t map_size = 0;
+    const void* entries = nullptr;
+    uint64_t count = 0;
+    int max_ply = 0;
+};
+
+}
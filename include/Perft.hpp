@@ -0,0 +1,39 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace coup {
+
+// Perft: counts every legal action sequence of exactly `depth` actions from a
+// position, exercising the move generator and the copy-make path. Lines that
+// end the game early do not count, as in chess perft.
+
+struct PerftResult {
+    uint64_t nodes = 0;
+    std::array<uint64_t, NUM_ACTION_TYPES> by_type{};  // by the last action's type
+
+    PerftResult& operator+=(const PerftResult& other);
+    bool operator==(const PerftResult&) const = default;
+};
+
+struct PerftOptions {
+    unsigned threads = 1;   // > 1 splits the root moves across threads
+    size_t table_mb = 0;    // > 0 caches subtrees by (state hash, depth), per thread
+};
+
+// Throws on a negative depth.
+PerftResult perft(const GameState& state, int depth, const PerftOptions& options = {});
+
+// Per root move breakdown ("divide"), useful for bisecting a wrong total.
+// Empty at depth 0, where there is no root move; throws on a negative depth.
+std::vector<std::pair<Action, PerftResult>> perft_divide(const GameState& state, int depth,
+                                                         const PerftOptions& options = {});
+
+}
@@ -1,12 +1,14 @@
 // Email: adhamhamoudy3@gmail.com
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <stdexcept>
 
 namespace coup {
 
 class Game;
+enum class ActionType : uint8_t;
 
 class Player {
 protected:
@@ -22,6 +24,11 @@ protected:
     bool used_bribe = false;    // Allows a second action in same turn
     std::string last_action = "";  // Track last action for Governor undo
 
+    // Ends the turn after an action; end_turn() is the Skip action itself
+    void pass_turn();
+    // Adds a successful action to the game's history
+    void record(ActionType type, const Player* target = nullptr);
+
 public:
     // Constructor / Destructor
     Player(Game& game, const std::string& name);
@@ -52,6 +59,7 @@ public:
     }
 
     // Turn handling
+    virtual void start_turn() {}  // Called by Game when the turn passes to this player
     virtual void validate_turn() const;
     virtual void end_turn();
     virtual void undo(Player& other) {
@@ -70,8 +78,14 @@ public:
 
     // Helpers for role logic
     bool has_used_bribe() const { return used_bribe; }
+    bool is_arrested() const { return was_arrested; }
+    bool is_sanctioned() const { return under_sanction; }
+    std::string get_last_target() const { return last_target; }
     void set_used_bribe(bool val) { used_bribe = val; }
 
+    // Game::apply_batch sets the fields directly
+    friend class Game;
+
     std::string get_last_action() const { return last_action; }
     void set_last_action(const std::string& action) { last_action = action; }
     void clear_last_action() { last_action = ""; }
@@ -0,0 +1,41 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "Bot.hpp"
+#include "Rollout.hpp"
+
+#include <cstdint>
+
+namespace coup {
+
+// A fixed (possibly mixed) strategy: a probability for each legal action of
+// the player to move. It must depend only on the state, and be safe to call
+// from several threads at once.
+class Policy {
+public:
+    virtual ~Policy() = default;
+
+    // probs[i] is the chance of legal[i]; the probabilities sum to 1.
+    virtual void distribution(const GameState& state, const ActionList& legal, float* probs) const = 0;
+};
+
+// Every legal action equally likely.
+class UniformPolicy : public Policy {
+public:
+    void distribution(const GameState& state, const ActionList& legal, float* probs) const override;
+};
+
+// Plays a Policy by sampling from it.
+class PolicyBot : public Bot {
+public:
+    explicit PolicyBot(const Policy& policy, uint64_t seed = 1) : policy(policy), rng(seed) {}
+
+    std::string name() const override { return "policy"; }
+    Action choose(const GameState& state) override;
+
+private:
+    const Policy& policy;
+    FastRng rng;
+};
+
+}
@@ -0,0 +1,154 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace coup {
+
+// Replay file:
+//   "COUPRPLY", varint format version, varint rules version, u64 seed,
+//   u8 seats, one u8 role per seat, one name per seat (varint length, bytes)
+//   one varint per action, then the varint end code
+//   keyframes: u32 count, u32 interval, then per keyframe the u32 offset of
+//   its action in the stream, the u8 previous actor, 3 zero bytes and the
+//   32-byte state before it (one keyframe per `interval` actions, from 0)
+//   footer: u64 file offset of the keyframe count, u64 action count,
+//   u64 final state hash, "COUPEND" and a 0 byte
+// Integers are little-endian. An action is coded relative to the previous
+// actor: type + 10 * (target + 6 * step), where step is how many seats the
+// turn moved on (usually 1) and target is 0 for none or how many seats
+// after the actor it sits. Most actions fit in one byte, all in two.
+// Version 1 files have no keyframes or keyframe offset; both are read.
+
+const uint32_t REPLAY_FORMAT_VERSION = 2;
+const size_t REPLAY_FOOTER_SIZE = 24;   // the last bytes: action count, final hash, end magic
+
+struct ReplayHeader {
+    uint32_t rules_version = RULES_VERSION;
+    uint64_t seed = 0;                 // whatever produced the deal, for the archive
+    std::vector<Role> roles;           // one per seat; the game starts at GameState::initial(roles)
+    std::vector<std::string> names;    // empty, or one per seat
+
+    GameState start() const { return GameState::initial(roles); }
+};
+
+struct ReplayFooter {
+    uint64_t actions = 0;
+    uint64_t final_hash = 0;           // GameState::hash() after the last action
+};
+
+// Streams a replay out action by action. It follows the game itself to
+// take a keyframe every keyframe_interval actions (0 = none); those are
+// held until finish() writes them with the footer.
+class ReplayWriter {
+public:
+    ReplayWriter(std::ostream& out, const ReplayHeader& header, uint32_t keyframe_interval = 64);
+
+    void write(const Action& action);
+    void finish();
+    uint64_t actions() const { return count; }
+    const GameState& state() const { return game; }
+
+private:
+    std::ostream& out;
+    int seats = 0;
+    int previous = 0;   // last actor
+    uint64_t count = 0;
+    uint32_t interval = 0;
+    uint64_t header_bytes = 0;
+    uint64_t stream_bytes = 0;
+    GameState game;
+    std::vector<uint8_t> keyframes;
+    bool finished = false;
+};
+
+// Streams a replay in. next() returns false after the last action, and
+// the footer is then available. Throws on a malformed or truncated file,
+// or one from other rules.
+class ReplayReader {
+public:
+    explicit ReplayReader(std::istream& in);
+
+    const ReplayHeader& header() const { return head; }
+    bool next(Action& action);
+    const ReplayFooter& footer() const;
+
+private:
+    std::istream& in;
+    uint32_t version = 0;
+    ReplayHeader head;
+    ReplayFooter foot;
+    int previous = 0;
+    uint64_t count = 0;
+    bool done = false;
+};
+
+// Writes a whole game to path.
+void save_replay(const std::string& path, const ReplayHeader& header, const std::vector<Action>& actions);
+
+// A position in a mapped replay: the state before action index(), and the
+// actions from there, decoded one at a time straight from the mapping.
+class ReplayCursor {
+public:
+    const GameState& state() const { return game; }
+    uint64_t index() const { return at; }
+
+    // Decodes the next action and applies it; false at the end. Throws if
+    // the action is malformed or illegal in state().
+    bool next(Action& action);
+
+private:
+    friend class ReplayFile;
+    const uint8_t* p = nullptr;
+    const uint8_t* end = nullptr;
+    int previous = 0;
+    uint64_t at = 0;
+    uint64_t count = 0;
+    GameState game;
+};
+
+// A replay file mapped read-only. seek() starts from the nearest keyframe
+// at or before the target, so reaching any action costs at most one
+// keyframe interval of decoding.
+class ReplayFile {
+public:
+    // Throws if invalid, or recorded under other rules unless any_rules.
+    explicit ReplayFile(const std::string& path, bool any_rules = false);
+    ~ReplayFile();
+    ReplayFile(const ReplayFile&) = delete;
+    ReplayFile& operator=(const ReplayFile&) = delete;
+
+    const ReplayHeader& header() const { return head; }
+    const ReplayFooter& footer() const { return foot; }
+    uint32_t keyframe_interval() const { return interval; }
+
+    // Cursor before action `index` (0 = the start, footer().actions = the end).
+    ReplayCursor seek(uint64_t index) const;
+
+    // Replays the whole game from the start under the current rules and
+    // returns the final state hash, for comparing with footer().final_hash.
+    // Throws on an illegal action, a keyframe that disagrees with the
+    // game, or bytes left over in the action stream.
+    uint64_t replay_hash() const;
+
+private:
+    void unmap();
+
+    int fd = -1;
+    void* map = nullptr;
+    size_t map_size = 0;
+    const uint8_t* stream = nullptr;      // first action
+    const uint8_t* stream_end = nullptr;  // the end code
+    const uint8_t* keys = nullptr;        // first keyframe
+    uint32_t keyframe_count = 0;
+    uint32_t interval = 0;
+    ReplayHeader head;
+    ReplayFooter foot;
+};
+
+}
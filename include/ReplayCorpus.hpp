@@ -0,0 +1,40 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace coup {
+
+struct CorpusConfig {
+    unsigned threads = 0;       // 0 = hardware threads
+    size_t batch = 256;         // files per pool task
+    bool any_rules = false;     // also replay files recorded under other rules
+    size_t max_problems = 1000; // problems kept for the report; all are counted
+};
+
+struct CorpusProblem {
+    std::string path;
+    std::string what;
+};
+
+struct CorpusReport {
+    uint64_t files = 0;
+    uint64_t actions = 0;
+    uint64_t mismatches = 0;    // replayed, but to another final hash
+    uint64_t errors = 0;        // unreadable, malformed or illegal
+    std::vector<CorpusProblem> problems;  // sorted by path
+
+    bool ok() const { return mismatches == 0 && errors == 0; }
+};
+
+// Re-simulates every *.replay file under dir (recursively) from its header
+// and action stream and compares the final state hash with the footer's.
+// The walk feeds batches of paths to a WorkStealingPool as it goes, and
+// each file is read through its mapping (ReplayFile::replay_hash), so the
+// archive is never loaded whole. Throws if dir is not a directory.
+CorpusReport verify_corpus(const std::string& dir, const CorpusConfig& config = {});
+
+}
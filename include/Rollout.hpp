@@ -0,0 +1,41 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace coup {
+
+// Heuristic: coup the richest, else mostly tax/invest. Greedy, Economic and
+// Aggressive play the HeuristicBot presets with 10% random moves.
+enum class RolloutPolicy { Random, Heuristic, Greedy, Economic, Aggressive };
+
+// Small, fast generator for playouts (splitmix64).
+class FastRng {
+    uint64_t s;
+
+public:
+    explicit FastRng(uint64_t seed) : s(seed) {}
+    uint64_t next() {
+        uint64_t z = (s += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>((next() >> 32) * n >> 32); }
+};
+
+// Reward per seat: 1 for the winner, 0 for everyone else. An unfinished game
+// splits the point between the seats still alive.
+using Rewards = std::array<float, MAX_PLAYERS>;
+Rewards final_rewards(const GameState& state);
+
+// Picks one legal action for the player to move.
+Action rollout_action(const GameState& state, RolloutPolicy policy, FastRng& rng);
+
+// Plays the game out from state for at most max_plies actions.
+Rewards rollout(GameState state, RolloutPolicy policy, int max_plies, FastRng& rng);
+
+}
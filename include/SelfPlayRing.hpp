@@ -0,0 +1,74 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "VecEnv.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace coup {
+
+// One training sample: what the mover saw, the search's visit distribution
+// over the VecEnv action indices, and the reward that seat finally got.
+struct SelfPlayRecord {
+    float obs[OBS_SIZE];
+    float policy[NUM_ENV_ACTIONS];
+    float outcome = 0;
+    uint32_t actor = 0;        // producer id, for the learner's bookkeeping
+    uint32_t game = 0;         // per actor
+    uint16_t ply = 0;
+    uint8_t seat = 0;
+    uint8_t num_seats = 0;
+};
+
+// Bounded multi-producer, single-consumer queue of SelfPlayRecords in POSIX
+// shared memory (shm_open + mmap), so actor processes hand samples to a
+// learner process without sockets or files. Producers claim slots with a
+// CAS on the head and publish them through a per-slot sequence number
+// (Vyukov's bounded queue); no locks, no system calls while there is room.
+// When the ring is full a producer backs off - yield, then sleeps of up to
+// a millisecond - until the learner catches up (backpressure), and counts
+// the stall. A producer that dies between claiming and publishing a slot
+// blocks the learner at that slot.
+class SelfPlayRing {
+public:
+    // Learner side: creates /name (replacing a stale one) with `capacity`
+    // slots, a power of two. The segment is unlinked when this is destroyed.
+    SelfPlayRing(const std::string& name, uint32_t capacity);
+    // Actor side: maps a ring some learner created.
+    explicit SelfPlayRing(const std::string& name);
+    ~SelfPlayRing();
+    SelfPlayRing(const SelfPlayRing&) = delete;
+    SelfPlayRing& operator=(const SelfPlayRing&) = delete;
+
+    uint32_t capacity() const;
+    size_t size() const;                 // approximate while producers run
+
+    bool try_push(const SelfPlayRecord& record);  // false if full or closed
+    bool push(const SelfPlayRecord& record);      // waits for room; false once closed
+
+    // Single consumer: moves up to max published records to out, oldest
+    // first, without waiting.
+    size_t pop_batch(SelfPlayRecord* out, size_t max);
+
+    // Tells producers to stop; push() then returns false.
+    void close();
+    bool closed() const;
+
+    uint64_t pushed() const;
+    uint64_t stalls() const;             // pushes that had to wait for room
+
+private:
+    struct Shared;
+    void unmap();
+
+    std::string name;
+    bool owner = false;
+    int fd = -1;
+    void* map = nullptr;
+    size_t map_size = 0;
+    Shared* shared = nullptr;
+};
+
+}
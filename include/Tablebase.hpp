@@ -0,0 +1,76 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace coup {
+
+// Endgame tablebase: every two-player position solved by retrograde
+// analysis. A position is the role pair, both coin counts (below coin_cap),
+// the side to move and the flags the rules read with two players left
+// (arrested, sanctioned, bribed, "last arrested the other seat", "last
+// action was tax"). Positions from bigger tables map onto it once only two
+// seats are alive.
+//
+// File: a 64-byte header, then one byte per position: 0 = not solved (a
+// draw, or it depends on positions past coin_cap), 1..127 = win and
+// 0x80 | n = loss, where n is the pass that solved it - a bound on the
+// number of actions left, used to make progress when converting a win.
+
+const uint64_t ALL_ROLE_PAIRS = (1ULL << (NUM_ROLES * NUM_ROLES)) - 1;
+
+struct TablebaseConfig {
+    uint64_t role_pairs = ALL_ROLE_PAIRS;  // bit roles[0] * 6 + roles[1]
+    int coin_cap = 16;                     // coins 0..coin_cap-1, at most 16
+    unsigned threads = 1;
+    int max_passes = 127;                  // a checkpoint is written after each
+};
+
+enum class Outcome { Unknown, Win, Loss };
+
+struct TablebaseProbe {
+    Outcome outcome = Outcome::Unknown;  // for the player to move
+    int distance = 0;                    // pass that solved it
+};
+
+// Builds (or, if path holds a partial table for the same configuration and
+// rules, resumes) a tablebase. Returns the number of solved positions.
+uint64_t build_tablebase(const std::string& path, const TablebaseConfig& config,
+                         std::ostream* progress = nullptr);
+
+// A finished table, mapped read-only.
+class Tablebase {
+public:
+    explicit Tablebase(const std::string& path);  // throws if invalid
+    ~Tablebase();
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    int coin_cap() const;
+    uint64_t size() const;
+
+    // Unknown if the position has more than two players alive or is not
+    // covered by the table.
+    TablebaseProbe probe(const GameState& state) const;
+
+    // A move that keeps a won position won and gets closer to the end;
+    // false unless the position is a known win.
+    bool best_action(const GameState& state, Action& out) const;
+
+private:
+    void unmap();
+
+    int fd = -1;
+    void* map = nullptr;
+    size_t map_size = 0;
+    const uint8_t* values = nullptr;
+    uint64_t role_pairs = 0;
+    int cap = 0;
+};
+
+}
@@ -0,0 +1,89 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "Bot.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace coup {
+
+// A registered bot: a fresh instance is made for every game (bots keep
+// per-game state and are not shared between threads).
+struct Entrant {
+    std::string name;
+    std::function<std::unique_ptr<Bot>(uint64_t seed)> make;
+};
+
+enum class Schedule {
+    RoundRobin,  // every group of `seats` entrants meets once
+    Swiss        // each round groups entrants of similar rating
+};
+
+struct TournamentConfig {
+    Schedule schedule = Schedule::RoundRobin;
+    int seats = 2;             // bots per game, 2..6
+    int deals = 4;             // role deals per meeting, each played in every seat rotation
+    int rounds = 5;            // Swiss only
+    unsigned threads = 0;      // 0 = hardware threads
+    int max_plies = 400;       // longer games are draws between the seats left
+    double k_factor = 16;
+    uint64_t seed = 1;
+    std::string replay_dir;    // if set, every game is saved there as <deal>_<rotation>.replay
+};
+
+struct Rating {
+    std::string name;
+    double elo = 1500;
+    double margin = 0;         // about 95%: elo +- margin
+    uint64_t games = 0;
+    uint64_t wins = 0;
+    uint64_t draws = 0;
+};
+
+// Plays the schedule on a work-stealing pool. A meeting of `seats` entrants
+// is a set of role deals; each deal is played once per rotation of the
+// entrants around the table, so every entrant gets every seat and, with it,
+// every dealt role. Finished games update the ratings right away: the
+// order of elimination ranks the seats, and each pair of seats counts as
+// one Elo game (K split over the opponents). Margins come from each
+// entrant's pairwise score against the field.
+class Tournament {
+public:
+    Tournament(std::vector<Entrant> entrants, const TournamentConfig& config);
+
+    // Plays the whole schedule; throws if a bot returns an illegal move.
+    void run(std::ostream* progress = nullptr);
+
+    uint64_t games_played() const;
+    std::vector<Rating> table() const;  // best first
+
+private:
+    struct Stats {
+        double elo = 1500;
+        double score = 0;      // pairwise points
+        uint64_t pairings = 0;
+        uint64_t games = 0;
+        uint64_t wins = 0;
+        uint64_t draws = 0;
+    };
+
+    void play_deal(const std::vector<int>& group, uint64_t deal_id);
+    void record(const std::vector<int>& seat_entrant, const std::vector<int>& rank, bool draw);
+
+    std::vector<Entrant> entrants;
+    TournamentConfig config;
+    mutable std::mutex lock;
+    std::vector<Stats> stats;
+    uint64_t played = 0;
+    std::ostream* progress = nullptr;
+};
+
+void print_ratings(std::ostream& out, const std::vector<Rating>& table);
+
+}
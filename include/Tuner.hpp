@@ -0,0 +1,73 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "HeuristicBot.hpp"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace coup {
+
+// HeuristicParams as a flat vector (epsilon is not tuned).
+const int NUM_GENES = NUM_ACTION_TYPES + 3;
+using Genes = std::array<float, NUM_GENES>;
+Genes to_genes(const HeuristicParams& params);
+HeuristicParams from_genes(const Genes& genes);
+
+struct TunerConfig {
+    int population = 32;
+    int elite = 4;                 // best candidates kept unchanged
+    float mutation_rate = 0.3f;    // chance each gene is perturbed
+    float mutation_scale = 0.5f;   // noise, relative to the gene's size
+    int games = 400;               // per candidate per generation
+    int batch = 50;                // games per pool task
+    int seats = 3;
+    std::vector<HeuristicParams> opponents = {HeuristicParams::greedy(), HeuristicParams::economic(),
+                                              HeuristicParams::aggressive()};
+    unsigned threads = 0;          // 0 = hardware threads
+    std::string checkpoint;        // written after each generation; resumed from if present
+    uint64_t seed = 1;
+};
+
+struct Candidate {
+    Genes genes{};
+    double fitness = 0;            // mean reward over the generation's games
+};
+
+// Evolves HeuristicParams by playing them against the opponent pool.
+// Every candidate of a generation plays the same games - same deals,
+// seats, opponents and opponent random numbers - so fitness differences
+// come from the parameters rather than the luck of the draw. The games are
+// played in batches on a work-stealing pool. After scoring, the elite is
+// kept and the rest is bred by tournament selection, uniform crossover and
+// Gaussian mutation. Generation seeds derive from the config seed, so a
+// run resumed from a checkpoint continues exactly as it would have.
+class Tuner {
+public:
+    explicit Tuner(const TunerConfig& config);  // loads the checkpoint if it exists
+
+    void run(int generations, std::ostream* progress = nullptr);
+
+    int generation() const { return gen; }
+    const std::vector<Candidate>& population() const { return pop; }
+    const Candidate& best() const;  // of the last scored generation
+
+    // Mean reward of params over generation g's games.
+    double fitness(const HeuristicParams& params, int g) const;
+
+private:
+    double play(const HeuristicParams& params, int g, int game) const;  // candidate's reward
+    void score(int g);
+    void breed(int g);
+    void save() const;
+    bool load();
+
+    TunerConfig config;
+    std::vector<Candidate> pop;
+    int gen = 0;                   // generations finished
+};
+
+}
@@ -0,0 +1,80 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include "GameState.hpp"
+#include "Rollout.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace coup {
+
+// Observation of the seat to move; seats are listed from its point of
+// view (slot 0 is the mover, slot 1 the next seat, ...). Per slot: alive,
+// coins / 10, role one-hot, arrested, sanctioned, last action was a tax
+// (undoable). Then the mover's bribe flag and its last arrest target.
+// Other seats' coins and roles are zero unless the env shows everything.
+const int OBS_SEAT_FEATURES = 1 + 1 + NUM_ROLES + 3;
+const int OBS_SIZE = MAX_PLAYERS * OBS_SEAT_FEATURES + 1 + MAX_PLAYERS;
+
+// Discrete actions: type * MAX_PLAYERS + slot of the target (0 when the
+// type takes none), in the same mover-relative slots as the observation.
+const int NUM_ENV_ACTIONS = NUM_ACTION_TYPES * MAX_PLAYERS;
+
+int encode_action(const GameState& state, const Action& action);
+Action decode_action(const GameState& state, int index);
+
+// Writes OBS_SIZE floats for the seat to move.
+void write_observation(const GameState& state, bool full_information, float* obs);
+
+struct VecEnvConfig {
+    int num_envs = 64;
+    int num_seats = 2;
+    int max_plies = 400;        // longer games end and share the reward among the seats left
+    bool full_information = false;
+    uint64_t seed = 1;
+};
+
+// Caller-owned, contiguous, row per env. Any pointer may be null to skip
+// that output.
+struct EnvBuffers {
+    float* obs = nullptr;       // num_envs * OBS_SIZE
+    uint8_t* masks = nullptr;   // num_envs * NUM_ENV_ACTIONS, 1 = legal
+    float* rewards = nullptr;   // num_envs * MAX_PLAYERS, by absolute seat
+    uint8_t* dones = nullptr;   // num_envs
+    int32_t* seats = nullptr;   // num_envs, the seat the observation is for
+};
+
+// Steps num_envs independent self-play games in one call, writing straight
+// into the caller's buffers. Every seat is played by the caller: each step
+// takes one action per env for the seat to move there. A game that ends
+// reports its final rewards (1 / survivors to each survivor) and done = 1,
+// and is dealt again at once, so obs, masks and seats already describe the
+// next game's first turn. Rewards are 0 on every other step.
+class VecEnv {
+public:
+    explicit VecEnv(const VecEnvConfig& config);
+
+    int num_envs() const { return config.num_envs; }
+    const GameState& state(int env) const { return states[env]; }
+
+    // Deals every game again and writes obs, masks and seats.
+    void reset(const EnvBuffers& out);
+
+    // actions[i] is an index from the mask of env i. Throws, without stepping
+    // any game, if one is illegal.
+    void step(const int32_t* actions, const EnvBuffers& out);
+
+    void write_obs(int env, float* obs) const;
+    void write_mask(int env, uint8_t* mask) const;
+
+private:
+    void deal(int env);
+    void write(int env, const EnvBuffers& out) const;
+
+    VecEnvConfig config;
+    std::vector<GameState> states;
+    FastRng rng;
+};
+
+}
@@ -0,0 +1,57 @@
+// Email: adhamhamoudy3@gmail.com
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace coup {
+
+// Fixed set of worker threads, one task deque each. A worker runs its own
+// newest task first and, when its deque is empty, steals the oldest task
+// of another worker, so uneven tasks (a long six-player MCTS game next to
+// a short heuristic one) keep every thread busy. Tasks submitted from a
+// worker go to that worker's deque; others are dealt round-robin.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = 0);  // 0 = hardware threads
+    ~WorkStealingPool();                              // waits for the tasks left
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished. Rethrows the first
+    // exception a task threw since the last wait().
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool take(unsigned self, std::function<void()>& task);
+    void work(unsigned self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{0};   // in a deque
+    std::atomic<size_t> pending{0};  // queued or running
+    std::atomic<unsigned> next_queue{0};
+    std::mutex state_lock;
+    std::condition_variable wake;    // work arrived, or stopping
+    std::condition_variable idle;    // pending reached 0
+    bool stopping = false;
+    std::exception_ptr error;
+};
+
+}
@@ -0,0 +1,33 @@
+/* Email: adhamhamoudy3@gmail.com */
+/* Plain C interface to coup::VecEnv, exported by libcoup.so (make libcoup)
+   for trainers outside C++ (ctypes, cffi, ...). Buffers are owned by the
+   caller and laid out as documented in VecEnv.hpp; any of them may be NULL.
+   Functions returning int give 0 on success and -1 on error, with the
+   message in coup_env_last_error(). */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct coup_env coup_env;
+
+int coup_env_obs_size(void);
+int coup_env_num_actions(void);
+int coup_env_max_players(void);
+
+/* NULL on bad arguments. full_information != 0 shows every seat's coins and role. */
+coup_env* coup_env_create(int num_envs, int num_seats, int max_plies, int full_information, uint64_t seed);
+void coup_env_destroy(coup_env* env);
+
+int coup_env_reset(coup_env* env, float* obs, uint8_t* masks, int32_t* seats);
+int coup_env_step(coup_env* env, const int32_t* actions, float* obs, uint8_t* masks, float* rewards,
+                  uint8_t* dones, int32_t* seats);
+
+const char* coup_env_last_error(const coup_env* env);
+
+#ifdef __cplusplus
+}
+#endif
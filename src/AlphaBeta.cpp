@@ -0,0 +1,252 @@
+// Email: adhamhamoudy3@gmail.com
+#include "AlphaBeta.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const int MAX_PLY = 256;
+const int PROVEN = AlphaBeta::WIN - MAX_PLY;
+const int INF = AlphaBeta::WIN + 1;
+
+enum Bound : uint64_t { EXACT = 0, LOWER = 1, UPPER = 2 };
+
+// Table entry layout: score (16 bits, offset) | depth (8) | bound (2) |
+// move index (6) | valid flag.
+uint64_t pack(int score, int depth, Bound bound, int move) {
+    return static_cast<uint64_t>(score + 32768)
+         | static_cast<uint64_t>(depth) << 16
+         | static_cast<uint64_t>(bound) << 24
+         | static_cast<uint64_t>(move) << 26
+         | 1ULL << 32;
+}
+int unpack_score(uint64_t d) { return static_cast<int>(d & 0xFFFF) - 32768; }
+int unpack_depth(uint64_t d) { return static_cast<int>((d >> 16) & 0xFF); }
+Bound unpack_bound(uint64_t d) { return static_cast<Bound>((d >> 24) & 3); }
+int unpack_move(uint64_t d) { return static_cast<int>((d >> 26) & 0x3F); }
+
+// Win/loss scores are stored relative to the node, not the root.
+int to_table(int score, int ply) {
+    if (score >= PROVEN) return score + ply;
+    if (score <= -PROVEN) return score - ply;
+    return score;
+}
+int from_table(int score, int ply) {
+    if (score >= PROVEN) return score - ply;
+    if (score <= -PROVEN) return score + ply;
+    return score;
+}
+
+int opponent_of(const GameState& s, int me) {
+    for (int i = 0; i < s.num_seats; ++i) {
+        if (i != me && s.is_alive(i)) return i;
+    }
+    return me;
+}
+
+// Coins decide the endgame: 7 buys a coup, 10 forces one.
+int evaluate(const GameState& s) {
+    int me = s.to_move;
+    int opp = opponent_of(s, me);
+    int score = 10 * (s.coins[me] - s.coins[opp]);
+    if (s.coins[me] >= 7) score += 40;
+    if (s.coins[opp] >= 7) score -= 40;
+    return score;
+}
+
+int order_key(const Action& a) {
+    switch (a.type) {
+        case ActionType::Coup: return 6;
+        case ActionType::Tax:
+        case ActionType::Invest: return 5;
+        case ActionType::Arrest:
+        case ActionType::Sanction: return 4;
+        case ActionType::Bribe: return 3;
+        case ActionType::Gather: return 2;
+        case ActionType::Skip: return 1;
+        default: return 0;  // free actions last
+    }
+}
+
+} // namespace
+
+bool AlphaBetaResult::proven() const {
+    return score >= PROVEN || score <= -PROVEN;
+}
+
+class AlphaBeta::Worker {
+    AlphaBeta& owner;
+    bool main;
+    Deadline deadline;
+
+public:
+    uint64_t nodes = 0;
+
+    Worker(AlphaBeta& owner, bool main, Deadline deadline)
+        : owner(owner), main(main), deadline(deadline) {}
+
+    // Best root move at depth; false if the search was stopped part way.
+    bool search_root(const GameState& s, int depth, Action& best, int& score) {
+        int value = search(s, depth, -INF, INF, 0, &best);
+        if (owner.stop.load(memory_order_relaxed)) return false;
+        score = value;
+        return true;
+    }
+
+private:
+    bool out_of_time() {
+        if ((nodes++ & 4095) != 0) return owner.stop.load(memory_order_relaxed);
+        if (main && deadline.expired()) {
+            owner.stop.store(true, memory_order_relaxed);
+        }
+        return owner.stop.load(memory_order_relaxed);
+    }
+
+    int search(const GameState& s, int depth, int alpha, int beta, int ply, Action* root_best) {
+        if (out_of_time()) return 0;
+        if (s.is_terminal()) return s.winner() == s.to_move ? AlphaBeta::WIN - ply : -(AlphaBeta::WIN - ply);
+        if (depth <= 0 || ply >= MAX_PLY) return evaluate(s);
+
+        const uint64_t key = s.hash();
+        int tt_move = -1;
+        uint64_t data;
+        if (owner.probe(key, data)) {
+            tt_move = unpack_move(data);
+            int v = from_table(unpack_score(data), ply);
+            if (!root_best && unpack_depth(data) >= depth) {
+                Bound b = unpack_bound(data);
+                if (b == EXACT || (b == LOWER && v >= beta) || (b == UPPER && v <= alpha)) return v;
+            }
+        }
+
+        ActionList legal;
+        s.legal_actions(legal);
+        int order[MAX_ACTIONS];
+        int keys[MAX_ACTIONS];
+        for (int i = 0; i < legal.size(); ++i) {
+            order[i] = i;
+            keys[i] = i == tt_move ? 100 : order_key(legal[i]);
+        }
+        // Insertion sort: at most MAX_ACTIONS moves, stable for equal keys
+        for (int i = 1; i < legal.size(); ++i) {
+            for (int j = i; j > 0 && keys[order[j]] > keys[order[j - 1]]; --j) swap(order[j], order[j - 1]);
+        }
+
+        const int alpha_orig = alpha;
+        int best_value = -INF;
+        int best_move = order[0];
+        for (int k = 0; k < legal.size(); ++k) {
+            int i = order[k];
+            GameState child = s;
+            child.apply(legal[i]);
+            int v = child.to_move == s.to_move
+                ? search(child, depth - 1, alpha, beta, ply + 1, nullptr)
+                : -search(child, depth - 1, -beta, -alpha, ply + 1, nullptr);
+            if (owner.stop.load(memory_order_relaxed)) return 0;
+            if (v > best_value) {
+                best_value = v;
+                best_move = i;
+            }
+            if (v > alpha) alpha = v;
+            if (alpha >= beta) break;
+        }
+
+        Bound bound = best_value <= alpha_orig ? UPPER : best_value >= beta ? LOWER : EXACT;
+        owner.store(key, pack(to_table(best_value, ply), depth, bound, best_move));
+        if (root_best) *root_best = legal[best_move];
+        return best_value;
+    }
+};
+
+AlphaBeta::AlphaBeta(const AlphaBetaConfig& config) : config(config) {
+    if (this->config.threads == 0) this->config.threads = 1;
+    if (this->config.max_depth > 63) this->config.max_depth = 63;
+    size_t entries = 1;
+    size_t mb = this->config.table_mb ? this->config.table_mb : 1;
+    while (entries * 2 * sizeof(Entry) <= mb * 1024 * 1024) entries *= 2;
+    table.reset(new Entry[entries]);
+    mask = entries - 1;
+}
+
+AlphaBeta::~AlphaBeta() = default;
+
+void AlphaBeta::clear_table() {
+    for (size_t i = 0; i <= mask; ++i) {
+        table[i].check.store(0, memory_order_relaxed);
+        table[i].data.store(0, memory_order_relaxed);
+    }
+}
+
+bool AlphaBeta::probe(uint64_t key, uint64_t& data) const {
+    const Entry& e = table[key & mask];
+    data = e.data.load(memory_order_relaxed);
+    return data != 0 && (e.check.load(memory_order_relaxed) ^ data) == key;
+}
+
+// Depth-preferred: a shallower result only replaces an entry for another key.
+void AlphaBeta::store(uint64_t key, uint64_t data) {
+    Entry& e = table[key & mask];
+    uint64_t old = e.data.load(memory_order_relaxed);
+    if (old != 0 && (e.check.load(memory_order_relaxed) ^ old) == key && unpack_depth(old) > unpack_depth(data)) {
+        return;
+    }
+    e.data.store(data, memory_order_relaxed);
+    e.check.store(key ^ data, memory_order_relaxed);
+}
+
+AlphaBetaResult AlphaBeta::search(const GameState& state, Deadline deadline) {
+    if (state.alive_count() != 2) {
+        throw runtime_error("Alpha-beta needs exactly two players left.");
+    }
+    ActionList legal;
+    state.legal_actions(legal);
+
+    AlphaBetaResult result;
+    result.best = legal[0];
+    stop.store(false);
+    if (config.time_ms > 0) deadline = deadline.within(chrono::milliseconds(config.time_ms));
+
+    // Lazy SMP helpers: the same search, started one ply deeper on odd
+    // threads, filling the shared table until the main thread is done.
+    vector<Worker> helpers;
+    helpers.reserve(config.threads);
+    for (unsigned t = 1; t < config.threads; ++t) helpers.emplace_back(*this, false, deadline);
+    vector<thread> pool;
+    for (unsigned t = 1; t < config.threads; ++t) {
+        pool.emplace_back([&, t] {
+            Worker& w = helpers[t - 1];
+            for (int depth = 1 + (t & 1); depth <= config.max_depth && !stop.load(); ++depth) {
+                Action best;
+                int score;
+                w.search_root(state, depth, best, score);
+            }
+        });
+    }
+
+    Worker main(*this, true, deadline);
+    for (int depth = 1; depth <= config.max_depth; ++depth) {
+        Action best;
+        int score;
+        if (!main.search_root(state, depth, best, score)) break;
+        result.best = best;
+        result.score = score;
+        result.depth = depth;
+        if (result.proven()) break;
+    }
+    stop.store(true);
+    for (auto& t : pool) t.join();
+
+    result.nodes = main.nodes;
+    for (const Worker& w : helpers) result.nodes += w.nodes;
+    return result;
+}
+
+}
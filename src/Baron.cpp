@@ -1,5 +1,6 @@
 // Email: adhamhamoudy3@gmail.com
 #include "Baron.hpp"
+#include "GameState.hpp"
 
 using namespace std;
 
@@ -17,7 +18,8 @@ void Baron::invest() {
     }
     remove_coins(3);
     add_coins(6);
-    end_turn();
+    record(ActionType::Invest);
+    pass_turn();
 }
 
 void Baron::on_sanctioned_by(Player& attacker) {
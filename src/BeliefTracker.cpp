@@ -0,0 +1,230 @@
+// Email: adhamhamoudy3@gmail.com
+#include "BeliefTracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const int LAST_BIN = BeliefTracker::COIN_BINS - 1;
+
+int bin(int coins) {
+    return clamp(coins, 0, LAST_BIN);
+}
+
+bool normalize(BeliefTracker::Table& t) {
+    float total = 0;
+    for (const auto& row : t) {
+        for (float p : row) total += p;
+    }
+    if (total <= 0) return false;
+    for (auto& row : t) {
+        for (float& p : row) p /= total;
+    }
+    return true;
+}
+
+// Moves every cell to the coin count `next(role, coins)` returns, or drops
+// it if that is -1 (the action was impossible for that role and count).
+// Evidence that contradicts every cell leaves the table as it was.
+template <typename F>
+void update(BeliefTracker::Table& t, F next) {
+    BeliefTracker::Table out{};
+    for (int r = 0; r < NUM_ROLES; ++r) {
+        for (int c = 0; c < BeliefTracker::COIN_BINS; ++c) {
+            if (t[r][c] == 0) continue;
+            int n = next(static_cast<Role>(r), c);
+            if (n >= 0) out[r][bin(n)] += t[r][c];
+        }
+    }
+    if (normalize(out)) t = out;
+}
+
+} // namespace
+
+BeliefTracker::BeliefTracker(const GameState& start, int viewer, bool visible_coins)
+    : seat(viewer), num_seats(start.num_seats), coins_visible(visible_coins) {
+    known.fill(-1);
+    for (int i = 0; i < num_seats; ++i) {
+        Table& t = tables[i];
+        for (auto& row : t) row.fill(0);
+        for (int r = 0; r < NUM_ROLES; ++r) t[r][bin(start.coins[i])] = 1.0f / NUM_ROLES;
+        if (coins_visible || i == seat) known[i] = start.coins[i];
+    }
+    reveal(seat, start.roles[seat], start.coins[seat]);
+}
+
+void BeliefTracker::reveal(int s, Role role, int coins) {
+    for (auto& row : tables[s]) row.fill(0);
+    tables[s][static_cast<int>(role)][bin(coins)] = 1;
+}
+
+void BeliefTracker::reveal_coins(int s, int coins) {
+    Table& t = tables[s];
+    const int b = bin(coins);
+    Table out{};
+    for (int r = 0; r < NUM_ROLES; ++r) out[r][b] = t[r][b];
+    if (!normalize(out)) {
+        // The count is not one we thought possible: keep the role odds
+        for (int r = 0; r < NUM_ROLES; ++r) {
+            for (int c = 0; c < COIN_BINS; ++c) out[r][b] += t[r][c];
+        }
+    }
+    t = out;
+}
+
+void BeliefTracker::observe(const Action& a, const GameState& after) {
+    const int me = a.actor;
+    const int t = a.target;
+    Table& actor = tables[me];
+    auto free_turn = [](int c) { return c < 10; };  // 10+ coins must coup
+
+    switch (a.type) {
+        case ActionType::Gather:
+            update(actor, [&](Role, int c) { return free_turn(c) ? c + 1 : -1; });
+            break;
+        case ActionType::Tax:
+            update(actor, [&](Role r, int c) { return free_turn(c) ? c + (r == Role::Governor ? 3 : 2) : -1; });
+            break;
+        case ActionType::Bribe:
+            update(actor, [&](Role, int c) { return free_turn(c) && c >= 4 ? c - 4 : -1; });
+            break;
+        case ActionType::Invest:
+            update(actor, [&](Role r, int c) { return free_turn(c) && r == Role::Baron && c >= 3 ? c + 3 : -1; });
+            break;
+        case ActionType::Skip:
+            update(actor, [&](Role, int c) { return free_turn(c) ? c : -1; });
+            break;
+        case ActionType::Arrest:
+            update(actor, [&](Role, int c) { return free_turn(c) ? c + 1 : -1; });
+            update(tables[t], [](Role r, int c) {
+                if (r == Role::Merchant) return c - min(c, 2);
+                if (c < 1) return -1;
+                return r == Role::General ? c : c - 1;
+            });
+            break;
+        case ActionType::Sanction: {
+            // A Judge target costs one more coin; the viewer sees that in
+            // its own purse, and anyone sees it when coins are visible
+            const bool seen = known[me] >= 0;
+            const int paid = seen ? known[me] - after.coins[me] : 0;
+            if (seen) {
+                update(tables[t], [&](Role r, int c) { return (r == Role::Judge) == (paid == 4) ? c : -1; });
+            }
+            const float judge = role_probability(t, Role::Judge);
+            Table out{};
+            for (int r = 0; r < NUM_ROLES; ++r) {
+                for (int c = 3; c < 10; ++c) {
+                    out[r][c - 3] += actor[r][c] * (1 - judge);
+                    if (c >= 4) out[r][c - 4] += actor[r][c] * judge;
+                }
+            }
+            if (normalize(out)) actor = out;
+            update(tables[t], [](Role r, int c) { return r == Role::Baron ? c + 1 : c; });
+            break;
+        }
+        case ActionType::Coup: {
+            const bool survived = (after.alive >> t) & 1;
+            update(actor, [](Role, int c) { return c >= 7 ? c - 7 : -1; });
+            update(tables[t], [&](Role r, int c) {
+                const bool blocks = r == Role::General && c >= 5;
+                if (blocks != survived) return -1;
+                return blocks ? c - 5 : c;
+            });
+            break;
+        }
+        case ActionType::SpyOn:
+            update(actor, [](Role r, int c) { return r == Role::Spy ? c : -1; });
+            if (me == seat) reveal_coins(t, after.coins[t]);
+            break;
+        case ActionType::Undo:
+            update(actor, [](Role r, int c) { return r == Role::Governor ? c : -1; });
+            // A Governor's own tax never leaves a tax to undo
+            update(tables[t], [](Role r, int c) { return r != Role::Governor && c >= 2 ? c - 2 : -1; });
+            break;
+    }
+
+    // A Merchant with 3+ coins gets one more when its turn starts
+    if (!after.is_terminal() && after.to_move != me) {
+        update(tables[after.to_move], [](Role r, int c) { return r == Role::Merchant && c >= 3 ? c + 1 : c; });
+    }
+
+    reveal(seat, after.roles[seat], after.coins[seat]);
+    known[seat] = after.coins[seat];
+    if (coins_visible) {
+        for (int i = 0; i < num_seats; ++i) {
+            if (i != seat) reveal_coins(i, after.coins[i]);
+            known[i] = after.coins[i];
+        }
+    }
+}
+
+float BeliefTracker::role_probability(int s, Role role) const {
+    float p = 0;
+    for (float x : tables[s][static_cast<int>(role)]) p += x;
+    return p;
+}
+
+float BeliefTracker::coin_probability(int s, int coins) const {
+    if (coins < 0 || coins >= COIN_BINS) return 0;
+    float p = 0;
+    for (const auto& row : tables[s]) p += row[coins];
+    return p;
+}
+
+float BeliefTracker::expected_coins(int s) const {
+    float e = 0;
+    for (const auto& row : tables[s]) {
+        for (int c = 0; c < COIN_BINS; ++c) e += row[c] * static_cast<float>(c);
+    }
+    return e;
+}
+
+Role BeliefTracker::likely_role(int s) const {
+    int best = 0;
+    for (int r = 1; r < NUM_ROLES; ++r) {
+        if (role_probability(s, static_cast<Role>(r)) > role_probability(s, static_cast<Role>(best))) best = r;
+    }
+    return static_cast<Role>(best);
+}
+
+GameState BeliefTracker::determinize(const GameState& actual, FastRng& rng) const {
+    GameState s = actual;
+    for (int i = 0; i < s.num_seats; ++i) {
+        if (i == seat) continue;
+        float x = static_cast<float>(rng.next() >> 40) / static_cast<float>(1 << 24);
+        int pick = 0;
+        for (int k = 0; k < NUM_ROLES * COIN_BINS; ++k) {
+            const float p = tables[i][k / COIN_BINS][k % COIN_BINS];
+            if (p == 0) continue;
+            pick = k;
+            x -= p;
+            if (x < 0) break;
+        }
+        s.roles[i] = static_cast<Role>(pick / COIN_BINS);
+        s.coins[i] = static_cast<uint8_t>(pick % COIN_BINS);
+    }
+    return s;
+}
+
+string BeliefTracker::summary(int s) const {
+    array<int, NUM_ROLES> order{};
+    for (int r = 0; r < NUM_ROLES; ++r) order[r] = r;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return role_probability(s, static_cast<Role>(a)) > role_probability(s, static_cast<Role>(b));
+    });
+    auto percent = [&](int r) {
+        return to_string(static_cast<int>(lround(100 * role_probability(s, static_cast<Role>(r))))) + "%";
+    };
+    string out = role_name(static_cast<Role>(order[0])) + " " + percent(order[0]);
+    if (role_probability(s, static_cast<Role>(order[1])) > 0.005f) {
+        out += ", " + role_name(static_cast<Role>(order[1])) + " " + percent(order[1]);
+    }
+    return out + " - about " + to_string(static_cast<int>(lround(expected_coins(s)))) + " coins";
+}
+
+}
@@ -0,0 +1,153 @@
+// Email: adhamhamoudy3@gmail.com
+#include "BestResponse.hpp"
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+// Lock-free memo: each slot keeps key ^ data beside data, as in AlphaBeta,
+// so a torn write from another thread reads as a miss.
+class Memo {
+    struct Entry {
+        atomic<uint64_t> check{0};
+        atomic<uint64_t> data{0};
+    };
+    unique_ptr<Entry[]> table;
+    size_t mask;
+
+public:
+    explicit Memo(size_t mb) {
+        size_t entries = 1;
+        while (entries * 2 * sizeof(Entry) <= (mb ? mb : 1) * 1024 * 1024) entries *= 2;
+        table.reset(new Entry[entries]);
+        mask = entries - 1;
+    }
+
+    bool find(uint64_t key, float& value) const {
+        const Entry& e = table[key & mask];
+        uint64_t data = e.data.load(memory_order_relaxed);
+        if (data == 0 || (e.check.load(memory_order_relaxed) ^ data) != key) return false;
+        value = bit_cast<float>(static_cast<uint32_t>(data));
+        return true;
+    }
+
+    void store(uint64_t key, float value) {
+        uint64_t data = bit_cast<uint32_t>(value) | 1ULL << 32;
+        Entry& e = table[key & mask];
+        e.data.store(data, memory_order_relaxed);
+        e.check.store(key ^ data, memory_order_relaxed);
+    }
+};
+
+class Responder {
+    const Policy& policy;
+    const BestResponseConfig& config;
+    Memo& memo;
+    const int responder;
+
+public:
+    uint64_t nodes = 0;
+
+    Responder(const Policy& policy, const BestResponseConfig& config, Memo& memo, int responder)
+        : policy(policy), config(config), memo(memo), responder(responder) {}
+
+    float value(const GameState& s, int depth) {
+        ++nodes;
+        if (s.is_terminal()) return s.winner() == responder ? 1.0f : -1.0f;
+        if (depth == 0) return horizon(s);
+
+        const uint64_t key = s.hash() ^ static_cast<uint64_t>(responder) << 56 ^ static_cast<uint64_t>(depth) << 48;
+        float v;
+        if (memo.find(key, v)) return v;
+
+        ActionList legal;
+        s.legal_actions(legal);
+        if (s.to_move == responder) {
+            v = -1.0f;
+            for (const Action& a : legal) {
+                GameState child = s;
+                child.apply(a);
+                float c = value(child, depth - 1);
+                if (c > v) v = c;
+                if (v >= 1.0f) break;  // cannot do better than a win
+            }
+        } else {
+            float probs[MAX_ACTIONS];
+            policy.distribution(s, legal, probs);
+            v = 0;
+            for (int i = 0; i < legal.size(); ++i) {
+                if (probs[i] <= 1e-6f) continue;
+                GameState child = s;
+                child.apply(legal[i]);
+                v += probs[i] * value(child, depth - 1);
+            }
+        }
+        memo.store(key, v);
+        return v;
+    }
+
+private:
+    float horizon(const GameState& s) const {
+        if (!config.tablebase) return 0;
+        TablebaseProbe p = config.tablebase->probe(s);
+        if (p.outcome == Outcome::Unknown) return 0;
+        bool mover_wins = p.outcome == Outcome::Win;
+        return mover_wins == (s.to_move == responder) ? 1.0f : -1.0f;
+    }
+};
+
+} // namespace
+
+double best_response_value(const Policy& policy, const GameState& start, int responder,
+                           const BestResponseConfig& config) {
+    if (start.alive_count() != 2 || !start.is_alive(responder)) {
+        throw runtime_error("Best response needs two players left, the responder among them.");
+    }
+    Memo memo(config.table_mb);
+    Responder r(policy, config, memo, responder);
+    return r.value(start, config.depth);
+}
+
+ExploitabilityResult exploitability(const Policy& policy, const BestResponseConfig& config) {
+    Memo memo(config.table_mb);
+    const int deals = NUM_ROLES * NUM_ROLES;
+    vector<float> values(2 * deals);
+    atomic<int> next{0};
+    atomic<uint64_t> nodes{0};
+
+    auto work = [&] {
+        for (int task; (task = next.fetch_add(1)) < 2 * deals;) {
+            int seat = task / deals;
+            int deal = task % deals;
+            GameState start = GameState::initial({static_cast<Role>(deal / NUM_ROLES),
+                                                  static_cast<Role>(deal % NUM_ROLES)});
+            Responder r(policy, config, memo, seat);
+            values[task] = r.value(start, config.depth);
+            nodes += r.nodes;
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < config.threads; ++t) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+
+    ExploitabilityResult result;
+    for (int seat = 0; seat < 2; ++seat) {
+        for (int deal = 0; deal < deals; ++deal) result.by_seat[seat] += values[seat * deals + deal];
+        result.by_seat[seat] /= deals;
+    }
+    result.value = (result.by_seat[0] + result.by_seat[1]) / 2;
+    result.nodes = nodes;
+    return result;
+}
+
+}
@@ -0,0 +1,48 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Bot.hpp"
+#include "GameBridge.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace coup {
+
+Action play_turn(Bot& bot, Game& game, Deadline deadline) {
+    const vector<Player*>& seats = game.seats();
+    GameState state = state_from_players(game, seats);
+    if (state.is_terminal()) {
+        throw runtime_error("Game is already over.");
+    }
+
+    const vector<Action>& history = game.history();
+    if (bot.followed != &game || bot.followed_seat != state.to_move || bot.seen > history.size()) {
+        vector<Role> roles;
+        for (const Player* p : seats) roles.push_back(role_from_name(p->role()));
+        bot.followed = &game;
+        bot.followed_seat = state.to_move;
+        bot.seen = 0;
+        bot.replayed = GameState::initial(roles);
+        bot.on_game_start(bot.replayed, state.to_move);
+    }
+    for (; bot.seen < history.size(); ++bot.seen) {
+        const Action& a = history[bot.seen];
+        if (!bot.replayed.is_legal(a)) break;
+        bot.replayed.apply(a);
+        bot.on_action(a, bot.replayed);
+    }
+    if (bot.seen < history.size() || bot.replayed.hash() != state.hash()) {
+        bot.seen = history.size();
+        bot.replayed = state;
+        bot.on_game_start(state, state.to_move);
+    }
+
+    Action action = bot.decide(state, deadline);
+    perform(action, seats);
+    return action;
+}
+
+}
@@ -0,0 +1,236 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Cfr.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'O', 'U', 'P', 'C', 'F', 'R', 0};
+const uint32_t FORMAT_VERSION = 1;
+
+int bucket(int coins) {
+    if (coins <= 0) return 0;
+    if (coins <= 2) return 1;
+    if (coins == 3) return 2;
+    if (coins == 4) return 3;
+    if (coins <= 6) return 4;
+    if (coins <= 9) return 5;
+    return 6;
+}
+
+int opponent_of(const GameState& s, int me) {
+    for (int i = 0; i < s.num_seats; ++i) {
+        if (i != me && s.is_alive(i)) return i;
+    }
+    return me;
+}
+
+int type_of(const Action& a) {
+    return static_cast<int>(a.type);
+}
+
+} // namespace
+
+uint32_t cfr_infoset(const GameState& s) {
+    if (s.alive_count() != 2) {
+        throw runtime_error("The CFR abstraction needs exactly two players left.");
+    }
+    const int me = s.to_move;
+    const int opp = opponent_of(s, me);
+    const uint8_t my_bit = static_cast<uint8_t>(1u << me);
+    uint32_t flags = ((s.sanctioned & my_bit) ? 1 : 0)
+                   | ((s.bribed & my_bit) ? 2 : 0)
+                   | (s.last_target[me] == opp ? 4 : 0)
+                   | (((s.arrested >> opp) & 1) ? 8 : 0)
+                   | (s.last_action[opp] == static_cast<uint8_t>(ActionType::Tax) ? 16 : 0);
+    uint32_t last = s.last_action[opp] == NO_ACTION ? NUM_ACTION_TYPES : s.last_action[opp];
+
+    uint32_t idx = static_cast<uint32_t>(s.roles[me]);
+    idx = idx * CFR_COIN_BUCKETS + bucket(s.coins[me]);
+    idx = idx * CFR_COIN_BUCKETS + bucket(s.coins[opp]);
+    idx = idx * 32 + flags;
+    idx = idx * (NUM_ACTION_TYPES + 1) + last;
+    return idx;
+}
+
+CfrPolicy::CfrPolicy(vector<float> probs) : table(move(probs)) {
+    if (table.size() != static_cast<size_t>(CFR_INFOSETS) * NUM_ACTION_TYPES) {
+        throw runtime_error("CFR policy table has the wrong size.");
+    }
+}
+
+CfrPolicy::CfrPolicy(const string& path) {
+    ifstream in(path, ios::binary);
+    char magic[8];
+    uint32_t header[4];  // format version, rules version, infosets, actions
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+        || !in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        throw runtime_error(path + " is not a CFR policy.");
+    }
+    if (header[0] != FORMAT_VERSION || header[1] != RULES_VERSION || header[2] != CFR_INFOSETS
+        || header[3] != static_cast<uint32_t>(NUM_ACTION_TYPES)) {
+        throw runtime_error(path + " was saved for another abstraction or rules version.");
+    }
+    table.resize(static_cast<size_t>(CFR_INFOSETS) * NUM_ACTION_TYPES);
+    if (!in.read(reinterpret_cast<char*>(table.data()), static_cast<streamsize>(table.size() * sizeof(float)))) {
+        throw runtime_error(path + " is truncated.");
+    }
+}
+
+void CfrPolicy::save(const string& path) const {
+    ofstream out(path, ios::binary);
+    uint32_t header[4] = {FORMAT_VERSION, RULES_VERSION, CFR_INFOSETS, static_cast<uint32_t>(NUM_ACTION_TYPES)};
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), static_cast<streamsize>(table.size() * sizeof(float)));
+    if (!out) throw runtime_error("Cannot write " + path);
+}
+
+void CfrPolicy::distribution(const GameState& state, const ActionList& legal, float* probs) const {
+    float total = 0;
+    if (state.alive_count() == 2) {
+        const float* row = &table[static_cast<size_t>(cfr_infoset(state)) * NUM_ACTION_TYPES];
+        for (int i = 0; i < legal.size(); ++i) total += probs[i] = row[type_of(legal[i])];
+    }
+    for (int i = 0; i < legal.size(); ++i) {
+        probs[i] = total > 0 ? probs[i] / total : 1.0f / static_cast<float>(legal.size());
+    }
+}
+
+CfrSolver::CfrSolver(const CfrConfig& config)
+    : config(config),
+      regrets(new atomic<float>[static_cast<size_t>(CFR_INFOSETS) * NUM_ACTION_TYPES]()),
+      strategy_sum(new atomic<float>[static_cast<size_t>(CFR_INFOSETS) * NUM_ACTION_TYPES]()) {
+    if (this->config.threads == 0) this->config.threads = 1;
+}
+
+void CfrSolver::regret_matching(uint32_t infoset, const ActionList& legal, float* probs) const {
+    const atomic<float>* row = &regrets[static_cast<size_t>(infoset) * NUM_ACTION_TYPES];
+    float total = 0;
+    for (int i = 0; i < legal.size(); ++i) total += probs[i] = row[type_of(legal[i])].load(memory_order_relaxed);
+    for (int i = 0; i < legal.size(); ++i) {
+        probs[i] = total > 0 ? probs[i] / total : 1.0f / static_cast<float>(legal.size());
+    }
+}
+
+// Returns the traverser's expected utility (+1 win, -1 loss) under the
+// current strategies, sampling the opponent's actions.
+float CfrSolver::traverse(const GameState& s, int traverser, int depth, uint64_t weight, FastRng& rng) {
+    if (s.is_terminal()) return s.winner() == traverser ? 1.0f : -1.0f;
+    if (depth >= config.horizon) {
+        Rewards r = rollout(s, RolloutPolicy::Heuristic, 300, rng);
+        return r[traverser] - r[opponent_of(s, traverser)];
+    }
+
+    ActionList legal;
+    s.legal_actions(legal);
+    const uint32_t infoset = cfr_infoset(s);
+    float probs[MAX_ACTIONS];
+    regret_matching(infoset, legal, probs);
+    atomic<float>* regret_row = &regrets[static_cast<size_t>(infoset) * NUM_ACTION_TYPES];
+
+    if (s.to_move != traverser) {
+        atomic<float>* sum_row = &strategy_sum[static_cast<size_t>(infoset) * NUM_ACTION_TYPES];
+        for (int i = 0; i < legal.size(); ++i) {
+            sum_row[type_of(legal[i])].fetch_add(static_cast<float>(weight) * probs[i], memory_order_relaxed);
+        }
+        float r = static_cast<float>(rng.next() >> 40) / static_cast<float>(1 << 24);
+        int pick = legal.size() - 1;
+        for (int i = 0; i < legal.size(); ++i) {
+            r -= probs[i];
+            if (r < 0) {
+                pick = i;
+                break;
+            }
+        }
+        GameState child = s;
+        child.apply(legal[pick]);
+        return traverse(child, traverser, depth + 1, weight, rng);
+    }
+
+    float utility[MAX_ACTIONS];
+    float node = 0;
+    for (int i = 0; i < legal.size(); ++i) {
+        GameState child = s;
+        child.apply(legal[i]);
+        utility[i] = traverse(child, traverser, depth + 1, weight, rng);
+        node += probs[i] * utility[i];
+    }
+    for (int i = 0; i < legal.size(); ++i) {
+        atomic<float>& r = regret_row[type_of(legal[i])];
+        float updated = r.load(memory_order_relaxed) + utility[i] - node;
+        r.store(updated > 0 ? updated : 0, memory_order_relaxed);  // CFR+: clip at zero
+    }
+    return node;
+}
+
+void CfrSolver::run(uint64_t iterations, ostream* report, uint64_t report_every) {
+    const uint64_t start = done.load();
+    const uint64_t end = start + iterations;
+    atomic<uint64_t> next{start};
+    atomic<uint64_t> next_report{report_every ? start + report_every : UINT64_MAX};
+
+    auto work = [&](unsigned t) {
+        FastRng rng(config.seed * 0x9e3779b97f4a7c15ULL + start + t);
+        for (uint64_t it; (it = next.fetch_add(1)) < end;) {
+            GameState s = GameState::initial({static_cast<Role>(rng.below(NUM_ROLES)),
+                                              static_cast<Role>(rng.below(NUM_ROLES))});
+            int plies = static_cast<int>(rng.below(static_cast<uint32_t>(config.max_start_plies + 1)));
+            for (int p = 0; p < plies && !s.is_terminal(); ++p) {
+                GameState before = s;
+                s.apply(rollout_action(s, RolloutPolicy::Heuristic, rng));
+                if (s.is_terminal()) s = before;  // start before the end, not after
+            }
+            for (int traverser = 0; traverser < 2; ++traverser) {
+                traverse(s, traverser, 0, it + 1, rng);
+            }
+            uint64_t finished = done.fetch_add(1) + 1;
+            uint64_t due = next_report.load();
+            if (report && finished >= due && next_report.compare_exchange_strong(due, due + report_every)) {
+                *report << finished << " iterations, regret bound " << regret_bound() << endl;
+            }
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < config.threads; ++t) pool.emplace_back(work, t);
+    work(0);
+    for (auto& t : pool) t.join();
+}
+
+double CfrSolver::regret_bound() const {
+    const uint64_t t = done.load();
+    if (t == 0) return 0;
+    double sum = 0;
+    for (uint32_t i = 0; i < CFR_INFOSETS; ++i) {
+        float best = 0;
+        for (int a = 0; a < NUM_ACTION_TYPES; ++a) {
+            float r = regrets[static_cast<size_t>(i) * NUM_ACTION_TYPES + a].load(memory_order_relaxed);
+            if (r > best) best = r;
+        }
+        sum += best;
+    }
+    return sum / static_cast<double>(t);
+}
+
+CfrPolicy CfrSolver::policy() const {
+    vector<float> probs(static_cast<size_t>(CFR_INFOSETS) * NUM_ACTION_TYPES);
+    for (uint32_t i = 0; i < CFR_INFOSETS; ++i) {
+        float total = 0;
+        for (int a = 0; a < NUM_ACTION_TYPES; ++a) total += strategy_sum[static_cast<size_t>(i) * NUM_ACTION_TYPES + a].load();
+        for (int a = 0; a < NUM_ACTION_TYPES; ++a) {
+            size_t k = static_cast<size_t>(i) * NUM_ACTION_TYPES + a;
+            probs[k] = total > 0 ? strategy_sum[k].load() / total : 0;
+        }
+    }
+    return CfrPolicy(move(probs));
+}
+
+}
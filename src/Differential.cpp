@@ -0,0 +1,164 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Differential.hpp"
+#include "GameBridge.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const ActionType PROBE_TYPES[] = {
+    ActionType::Gather, ActionType::Tax, ActionType::Bribe, ActionType::Invest,
+    ActionType::Arrest, ActionType::Sanction, ActionType::Coup, ActionType::Undo
+};
+
+// Player accepts a few calls the engine never generates: ending a turn at
+// will, spying on a seat already spied on, targeting yourself, and Spy and
+// Governor abilities out of turn. Rejections are only compared outside those.
+bool rejection_is_checked(const GameState& state, const Action& a) {
+    return a.actor == state.to_move && a.type != ActionType::Skip
+        && a.type != ActionType::SpyOn && a.target != a.actor;
+}
+
+class Lockstep {
+    Game game;
+    vector<unique_ptr<Player>> owned;
+    vector<Player*> seats;
+    GameState state;
+
+public:
+    explicit Lockstep(const vector<Role>& roles) : state(GameState::initial(roles)) {
+        for (size_t i = 0; i < roles.size(); ++i) {
+            owned.emplace_back(create_player(game, roles[i], "P" + to_string(i)));
+            seats.push_back(owned.back().get());
+        }
+    }
+
+    const GameState& engine() const { return state; }
+
+    // Returns "" when both sides agree after the action.
+    string step(const Action& a) {
+        bool legal = state.is_legal(a);
+        if (!legal && !rejection_is_checked(state, a)) return "";
+
+        bool accepted = true;
+        string error;
+        try {
+            perform(a, seats);
+        } catch (const runtime_error& e) {
+            accepted = false;
+            error = e.what();
+        }
+        if (legal != accepted) {
+            return describe(a) + ": engine says " + (legal ? "legal" : "illegal") + ", Player "
+                 + (accepted ? "accepted it" : "rejected it (" + error + ")");
+        }
+        if (legal) state.apply(a);
+
+        GameState reference = state_from_players(game, seats);
+        if (reference.hash() != state.hash()) {
+            return describe(a) + ": states differ\n  engine:    " + state.describe()
+                 + "\n  reference: " + reference.describe();
+        }
+        return "";
+    }
+};
+
+} // namespace
+
+LockstepResult run_lockstep(uint64_t seed, int max_actions) {
+    mt19937_64 rng(seed);
+    Divergence d;
+    d.seed = seed;
+    int count = 2 + static_cast<int>(rng() % (MAX_PLAYERS - 1));
+    for (int i = 0; i < count; ++i) d.roles.push_back(static_cast<Role>(rng() % NUM_ROLES));
+
+    LockstepResult result;
+    Lockstep lockstep(d.roles);
+    ActionList legal;
+    for (int i = 0; i < max_actions && !lockstep.engine().is_terminal(); ++i) {
+        const GameState& s = lockstep.engine();
+        Action a;
+        if (rng() % 4 == 0) {
+            a.type = PROBE_TYPES[rng() % size(PROBE_TYPES)];
+            a.actor = s.to_move;
+            a.target = static_cast<uint8_t>((s.to_move + 1 + rng() % (s.num_seats - 1)) % s.num_seats);
+            if (!needs_target(a.type)) a.target = NO_SEAT;
+        } else {
+            s.legal_actions(legal);
+            a = legal[static_cast<int>(rng() % legal.size())];
+        }
+        d.actions.push_back(a);
+        ++result.actions;
+
+        string reason = lockstep.step(a);
+        if (!reason.empty()) {
+            d.reason = reason;
+            result.divergence = d;
+            break;
+        }
+    }
+    return result;
+}
+
+string replay_lockstep(const vector<Role>& roles, const vector<Action>& actions, size_t* failed_at) {
+    Lockstep lockstep(roles);
+    for (size_t i = 0; i < actions.size(); ++i) {
+        const Action& a = actions[i];
+        if (a.actor >= roles.size() || (needs_target(a.type) && a.target >= roles.size())) continue;
+        if (lockstep.engine().is_terminal()) break;
+        string reason = lockstep.step(a);
+        if (!reason.empty()) {
+            if (failed_at) *failed_at = i;
+            return reason;
+        }
+    }
+    return "";
+}
+
+Divergence minimize(const Divergence& divergence) {
+    Divergence best = divergence;
+    size_t chunk = best.actions.size() / 2;
+    if (chunk == 0) chunk = 1;
+    while (true) {
+        bool progress = false;
+        for (size_t start = 0; start + chunk <= best.actions.size();) {
+            vector<Action> candidate(best.actions.begin(), best.actions.begin() + start);
+            candidate.insert(candidate.end(), best.actions.begin() + start + chunk, best.actions.end());
+            size_t at = 0;
+            string reason = replay_lockstep(best.roles, candidate, &at);
+            if (!reason.empty()) {
+                candidate.resize(at + 1);
+                best.actions = candidate;
+                best.reason = reason;
+                progress = true;
+            } else {
+                start += chunk;
+            }
+        }
+        if (!progress) {
+            if (chunk == 1) break;
+            chunk /= 2;
+        }
+    }
+    return best;
+}
+
+string describe(const Divergence& divergence) {
+    string s = "seed " + to_string(divergence.seed) + ", roles:";
+    for (Role r : divergence.roles) s += " " + role_name(r);
+    s += "\n";
+    for (size_t i = 0; i < divergence.actions.size(); ++i) {
+        s += "  " + to_string(i + 1) + ". " + describe(divergence.actions[i]) + "\n";
+    }
+    return s + divergence.reason;
+}
+
+}
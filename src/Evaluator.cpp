@@ -0,0 +1,195 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Evaluator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'O', 'U', 'P', 'E', 'V', 'L', 0};
+const uint32_t FORMAT_VERSION = 1;
+const int LANES = EVAL_BATCH * MAX_PLAYERS;
+
+struct Sample {
+    GameState state;
+    uint8_t winner;
+};
+
+// Win chances from per-seat scores: softmax over the alive seats.
+Rewards softmax(const GameState& s, const float* scores) {
+    Rewards r{};
+    float top = -1e30f;
+    for (int i = 0; i < s.num_seats; ++i) {
+        if (s.is_alive(i)) top = max(top, scores[i]);
+    }
+    float total = 0;
+    for (int i = 0; i < s.num_seats; ++i) {
+        if (s.is_alive(i)) total += r[i] = exp(scores[i] - top);
+    }
+    for (int i = 0; i < s.num_seats; ++i) r[i] /= total;
+    return r;
+}
+
+} // namespace
+
+LinearEvaluator::LinearEvaluator(const string& path) {
+    ifstream in(path, ios::binary);
+    char magic[8];
+    uint32_t header[3];  // format version, rules version, features
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+        || !in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        throw runtime_error(path + " is not an evaluator.");
+    }
+    if (header[0] != FORMAT_VERSION || header[1] != RULES_VERSION || header[2] != NUM_FEATURES) {
+        throw runtime_error(path + " was saved for other features or rules.");
+    }
+    if (!in.read(reinterpret_cast<char*>(weights.data()), sizeof(weights))) {
+        throw runtime_error(path + " is truncated.");
+    }
+}
+
+void LinearEvaluator::save(const string& path) const {
+    ofstream out(path, ios::binary);
+    uint32_t header[3] = {FORMAT_VERSION, RULES_VERSION, NUM_FEATURES};
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(weights.data()), sizeof(weights));
+    if (!out) throw runtime_error("Cannot write " + path);
+}
+
+void LinearEvaluator::features(const GameState& s, int seat, float* f) {
+    const int c = s.coins[seat];
+    const uint8_t bit = static_cast<uint8_t>(1u << seat);
+    int threats = 0;
+    int richest = 0;
+    for (int i = 0; i < s.num_seats; ++i) {
+        if (i == seat || !s.is_alive(i)) continue;
+        if (s.coins[i] >= 7) ++threats;
+        richest = max(richest, static_cast<int>(s.coins[i]));
+    }
+    int wait = 0;  // turns before this seat moves
+    for (int i = s.to_move; i != seat; i = (i + 1) % s.num_seats) {
+        if (s.is_alive(i)) ++wait;
+    }
+    const float alive = static_cast<float>(s.alive_count());
+
+    f[0] = 1;
+    f[1] = static_cast<float>(c) / 10;
+    f[2] = c >= 3;
+    f[3] = c >= 7;
+    f[4] = c >= 10;
+    for (int r = 0; r < NUM_ROLES; ++r) f[5 + r] = s.roles[seat] == static_cast<Role>(r);
+    f[11] = (s.sanctioned & bit) != 0;
+    f[12] = (s.arrested & bit) != 0;
+    f[13] = static_cast<float>(wait) / alive;
+    f[14] = static_cast<float>(threats) / 5;
+    f[15] = static_cast<float>(richest) / 10;
+    f[16] = s.roles[seat] == Role::General && c >= 5;
+    f[17] = 1 / alive;
+}
+
+Rewards LinearEvaluator::evaluate(const GameState& state) const {
+    Rewards r;
+    evaluate_batch(&state, 1, &r);
+    return r;
+}
+
+void LinearEvaluator::evaluate_batch(const GameState* states, int count, Rewards* out) const {
+    alignas(32) float lanes[NUM_FEATURES][LANES];
+    alignas(32) float scores[LANES];
+    const int used = count * MAX_PLAYERS;
+
+    float f[NUM_FEATURES];
+    for (int b = 0; b < count; ++b) {
+        for (int seat = 0; seat < MAX_PLAYERS; ++seat) {
+            const int lane = b * MAX_PLAYERS + seat;
+            if (seat < states[b].num_seats && states[b].is_alive(seat)) {
+                features(states[b], seat, f);
+            } else {
+                fill(f, f + NUM_FEATURES, 0.0f);
+            }
+            for (int k = 0; k < NUM_FEATURES; ++k) lanes[k][lane] = f[k];
+        }
+    }
+
+    fill(scores, scores + used, 0.0f);
+    for (int k = 0; k < NUM_FEATURES; ++k) {
+        const float w = weights[k];
+        const float* col = lanes[k];
+        for (int lane = 0; lane < used; ++lane) scores[lane] += w * col[lane];
+    }
+    for (int b = 0; b < count; ++b) out[b] = softmax(states[b], scores + b * MAX_PLAYERS);
+}
+
+LinearEvaluator train_evaluator(const EvalTrainConfig& config, ostream* report) {
+    static const RolloutPolicy POLICIES[] = {RolloutPolicy::Greedy, RolloutPolicy::Economic,
+                                             RolloutPolicy::Aggressive, RolloutPolicy::Heuristic};
+    const unsigned threads = config.threads ? config.threads : 1;
+    vector<vector<Sample>> per_thread(threads);
+
+    auto play = [&](unsigned t) {
+        FastRng rng(config.seed * 0x9e3779b97f4a7c15ULL + t);
+        for (int g = static_cast<int>(t); g < config.games; g += static_cast<int>(threads)) {
+            vector<Role> roles(2 + rng.below(MAX_PLAYERS - 1));
+            for (Role& r : roles) r = static_cast<Role>(rng.below(NUM_ROLES));
+            RolloutPolicy policy = POLICIES[rng.below(4)];
+            GameState s = GameState::initial(roles);
+            vector<GameState> seen;
+            for (int ply = 0; ply < 400 && !s.is_terminal(); ++ply) {
+                seen.push_back(s);
+                s.apply(rollout_action(s, policy, rng));
+            }
+            if (!s.is_terminal()) continue;  // no winner to learn from
+            for (const GameState& p : seen) per_thread[t].push_back({p, static_cast<uint8_t>(s.winner())});
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(play, t);
+    play(0);
+    for (auto& t : pool) t.join();
+
+    vector<Sample> samples;
+    for (auto& list : per_thread) samples.insert(samples.end(), list.begin(), list.end());
+
+    LinearEvaluator eval;
+    FastRng rng(config.seed);
+    float f[MAX_PLAYERS][NUM_FEATURES];
+    float scores[MAX_PLAYERS];
+    for (int epoch = 0; epoch < config.epochs; ++epoch) {
+        for (size_t i = samples.size(); i > 1; --i) swap(samples[i - 1], samples[rng.below(static_cast<uint32_t>(i))]);
+        double loss = 0;
+        for (const Sample& sample : samples) {
+            const GameState& s = sample.state;
+            for (int seat = 0; seat < s.num_seats; ++seat) {
+                scores[seat] = 0;
+                if (!s.is_alive(seat)) continue;
+                LinearEvaluator::features(s, seat, f[seat]);
+                for (int k = 0; k < NUM_FEATURES; ++k) scores[seat] += eval.weights[k] * f[seat][k];
+            }
+            Rewards p = softmax(s, scores);
+            loss -= log(max(p[sample.winner], 1e-9f));
+            // Cross-entropy gradient: (p - y) times each seat's features
+            for (int seat = 0; seat < s.num_seats; ++seat) {
+                if (!s.is_alive(seat)) continue;
+                float g = p[seat] - (seat == sample.winner ? 1.0f : 0.0f);
+                for (int k = 0; k < NUM_FEATURES; ++k) eval.weights[k] -= config.learning_rate * g * f[seat][k];
+            }
+        }
+        if (report) {
+            *report << "epoch " << epoch + 1 << ": " << samples.size() << " positions, log loss "
+                    << (samples.empty() ? 0 : loss / static_cast<double>(samples.size())) << endl;
+        }
+    }
+    return eval;
+}
+
+}
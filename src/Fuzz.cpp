@@ -0,0 +1,276 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Fuzz.hpp"
+#include "GameBridge.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+#include "Governor.hpp"
+#include "Spy.hpp"
+#include "Baron.hpp"
+#include "General.hpp"
+#include "Judge.hpp"
+#include "Merchant.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+// Reads the fuzz input one byte at a time; reads past the end yield 0.
+class ByteReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+
+public:
+    ByteReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+    bool empty() const { return pos >= size; }
+    uint8_t next() { return pos < size ? data[pos++] : 0; }
+};
+
+enum FuzzAction : uint8_t {
+    GATHER, TAX, BRIBE, ARREST, SANCTION, COUP,
+    INVEST, SPY_ON, UNDO, CANCEL_BRIBE, BLOCK_COUP,
+    NUM_FUZZ_ACTIONS
+};
+
+const char* const ACTION_NAMES[NUM_FUZZ_ACTIONS] = {
+    "gather", "tax", "bribe", "arrest", "sanction", "coup",
+    "invest", "spy_on", "undo", "cancel_bribe", "block_coup"
+};
+
+const int MAX_SEATS = 6;
+const int MAX_PLAYOUT_STEPS = 500;
+const int BLOCK_WINDOW = 50;   // a play-out still running must have seen a blocked coup this recently
+
+atomic<uint64_t> abandoned{0};
+
+// Everything observable about one player, compared before/after rejected calls.
+struct PlayerSnapshot {
+    int coins = 0;
+    bool active = false;
+    bool arrested = false;
+    bool sanctioned = false;
+    bool bribed = false;
+    bool coup_blocked = false;
+    string last_action;
+    string last_target;
+
+    bool operator==(const PlayerSnapshot&) const = default;
+};
+
+struct Snapshot {
+    array<PlayerSnapshot, MAX_SEATS> seats;
+    size_t turn_index = 0;
+
+    bool operator==(const Snapshot&) const = default;
+};
+
+class Harness {
+    Game game;
+    vector<unique_ptr<Player>> seats;
+    size_t active_count = 0;
+
+public:
+    explicit Harness(ByteReader& in) {
+        int count = 2 + in.next() % (MAX_SEATS - 1);
+        for (int i = 0; i < count; ++i) {
+            Role role = static_cast<Role>(in.next() % NUM_ROLES);
+            seats.emplace_back(create_player(game, role, "P" + to_string(i)));
+        }
+        active_count = seats.size();
+        check_invariants([] { return string("setup"); });
+    }
+
+    bool finished() const { return active_count <= 1; }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        for (size_t i = 0; i < seats.size(); ++i) {
+            const Player& p = *seats[i];
+            s.seats[i] = {p.coins(), p.active(), p.is_arrested(), p.is_sanctioned(),
+                          p.has_used_bribe(), p.is_coup_blocked(),
+                          p.get_last_action(), p.get_last_target()};
+        }
+        s.turn_index = game.turn_index();
+        return s;
+    }
+
+    // Performs one call. Returns false if the rules rejected it, in which case
+    // the call must not have changed anything.
+    // Actor bytes below 0x80 mean "whoever's turn it is", which keeps most
+    // steps legal; the rest pick a seat directly to exercise out-of-turn calls.
+    bool step(uint8_t actor_byte, uint8_t action_byte, uint8_t target_byte) {
+        Player& actor = actor_byte < 0x80 ? *current_player() : *seats[actor_byte % seats.size()];
+        Player& target = *seats[target_byte % seats.size()];
+        FuzzAction action = static_cast<FuzzAction>(action_byte % NUM_FUZZ_ACTIONS);
+        auto where = [&] { return actor.name() + " " + ACTION_NAMES[action] + " " + target.name(); };
+
+        Snapshot before = snapshot();
+        bool accepted = true;
+        try {
+            accepted = perform(actor, action, target);
+        } catch (const runtime_error&) {
+            accepted = false;
+        }
+        if (!accepted && !(snapshot() == before)) {
+            throw InvariantViolation("rejected call changed the game state: " + where());
+        }
+        check_invariants(where);
+        return accepted;
+    }
+
+    // Finishes the game with a simple policy: coup when possible, otherwise
+    // gather, and skip the turn when gathering is not allowed (as the GUI does).
+    // Some tables never end under this policy (a Merchant against a General
+    // that keeps blocking), so those are abandoned after MAX_PLAYOUT_STEPS
+    // and counted. A play-out that runs that long without a coup being
+    // blocked lately is not a block war but a game that cannot end: a bug.
+    void play_out() {
+        int last_block = -BLOCK_WINDOW - 1;
+        for (int steps = 0; !finished(); ++steps) {
+            if (steps == MAX_PLAYOUT_STEPS) {
+                if (steps - last_block > BLOCK_WINDOW) {
+                    throw InvariantViolation("play-out did not end in " + to_string(MAX_PLAYOUT_STEPS)
+                                             + " steps, and no coup was blocked in the last "
+                                             + to_string(BLOCK_WINDOW));
+                }
+                abandoned.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+            Player* current = current_player();
+            Player* victim = nullptr;
+            for (auto& p : seats) {
+                if (p.get() != current && p->active()) {
+                    victim = p.get();
+                    break;
+                }
+            }
+            try {
+                if (current->coins() >= 7) {
+                    current->coup(*victim);
+                    if (victim->active()) last_block = steps;
+                } else {
+                    current->gather();
+                }
+            } catch (const runtime_error&) {
+                current->end_turn();
+            }
+            check_invariants([&] { return "play-out by " + current->name(); });
+        }
+
+        int winners = 0;
+        string expected;
+        for (auto& p : seats) {
+            if (p->active()) {
+                ++winners;
+                expected = p->name();
+            }
+        }
+        if (winners != 1) {
+            throw InvariantViolation("game ended with " + to_string(winners) + " active players");
+        }
+        if (game.winner() != expected) {
+            throw InvariantViolation("winner() reports " + game.winner() + ", expected " + expected);
+        }
+    }
+
+private:
+    Player* current_player() const {
+        string name = game.turn();
+        for (auto& p : seats) {
+            if (p->name() == name) return p.get();
+        }
+        throw InvariantViolation("turn() names an unknown player: " + name);
+    }
+
+    // Returns false without calling anything when the actor lacks the role;
+    // that is a harness decision, not a rule rejection worth an exception.
+    bool perform(Player& actor, FuzzAction action, Player& target) {
+        switch (action) {
+            case GATHER: actor.gather(); break;
+            case TAX: actor.tax(); break;
+            case BRIBE: actor.bribe(); break;
+            case ARREST: actor.arrest(target); break;
+            case SANCTION: actor.sanction(target); break;
+            case COUP: actor.coup(target); break;
+            case UNDO: actor.undo(target); break;
+            case INVEST:
+                if (Baron* baron = dynamic_cast<Baron*>(&actor)) baron->invest();
+                else return false;
+                break;
+            case SPY_ON:
+                if (Spy* spy = dynamic_cast<Spy*>(&actor)) spy->spy_on(target);
+                else return false;
+                break;
+            case CANCEL_BRIBE:
+                if (Judge* judge = dynamic_cast<Judge*>(&actor)) judge->cancel_bribe(target);
+                else return false;
+                break;
+            case BLOCK_COUP:
+                if (General* general = dynamic_cast<General*>(&actor)) general->block_coup(target);
+                else return false;
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    // where() describes the last step; it is only built when something fails
+    template <typename Where>
+    void check_invariants(Where where) {
+        size_t active = 0;
+        for (auto& p : seats) {
+            if (p->coins() < 0) {
+                throw InvariantViolation(p->name() + " has negative coins after " + where());
+            }
+            if (p->active()) ++active;
+        }
+        if (game.turn_index() >= active) {
+            throw InvariantViolation("turn index out of range after " + where());
+        }
+        // players() allocates, so only re-check membership when someone dropped out
+        if (active != active_count) {
+            vector<string> names = game.players();
+            if (names.size() != active) {
+                throw InvariantViolation("players() disagrees with active flags after " + where());
+            }
+            for (auto& p : seats) {
+                bool listed = false;
+                for (const string& n : names) {
+                    if (n == p->name()) listed = true;
+                }
+                if (listed != p->active()) {
+                    throw InvariantViolation(p->name() + " listed/eliminated mismatch after " + where());
+                }
+            }
+            active_count = active;
+        }
+    }
+};
+
+} // namespace
+
+uint64_t abandoned_playouts() {
+    return abandoned.load(memory_order_relaxed);
+}
+
+void fuzz_one_input(const uint8_t* data, size_t size) {
+    ByteReader in(data, size);
+    Harness harness(in);
+    while (!in.empty() && !harness.finished()) {
+        uint8_t actor = in.next();
+        uint8_t action = in.next();
+        uint8_t target = in.next();
+        harness.step(actor, action, target);
+    }
+    harness.play_out();
+}
+
+} // namespace coup
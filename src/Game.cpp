@@ -2,17 +2,39 @@
 #include "Game.hpp"
 #include "Player.hpp"
 #include "General.hpp"
+#include "GameState.hpp"
 using namespace std;
 
 namespace coup {
 
 Game::Game() {}
 
+Game::~Game() {}
+
 void Game::add_player(Player* player) {
     if (active_players.size() >= 6) {
         throw runtime_error("Maximum number of players (6) reached.");
     }
     active_players.push_back(player);
+    seat_order.push_back(player);
+}
+
+const vector<Player*>& Game::seats() const {
+    return seat_order;
+}
+
+const vector<Action>& Game::history() const {
+    return log;
+}
+
+void Game::record(ActionType type, const Player* actor, const Player* target) {
+    Action a;
+    a.type = type;
+    for (size_t i = 0; i < seat_order.size(); ++i) {
+        if (seat_order[i] == actor) a.actor = static_cast<uint8_t>(i);
+        if (seat_order[i] == target) a.target = static_cast<uint8_t>(i);
+    }
+    log.push_back(a);
 }
 
 vector<string> Game::players() const {
@@ -23,6 +45,10 @@ vector<string> Game::players() const {
     return names;
 }
 
+const vector<Player*>& Game::player_list() const {
+    return active_players;
+}
+
 string Game::turn() const {
     if (active_players.empty()) {
         throw runtime_error("No players in game.");
@@ -30,6 +56,10 @@ string Game::turn() const {
     return active_players.at(current_turn_index)->name();
 }
 
+size_t Game::turn_index() const {
+    return current_turn_index;
+}
+
 string Game::winner() const {
     if (active_players.size() == 1) {
         return active_players.at(0)->name();
@@ -61,8 +91,7 @@ void Game::eliminate(Player* player) {
 void Game::advance_turn() {
     if (active_players.empty()) return;
     current_turn_index = (current_turn_index + 1) % active_players.size();
-    // Future improvement: trigger start_turn if needed
-    // active_players[current_turn_index]->start_turn();
+    active_players[current_turn_index]->start_turn();
 }
 
 void Game::coup(Player* attacker, Player* target) {
@@ -89,4 +118,101 @@ void Game::coup(Player* attacker, Player* target) {
     advance_turn();
 }
 
+// Player::end_turn without the virtual call
+void Game::end_turn(Player* p) {
+    if (p->used_bribe) {
+        p->used_bribe = false;
+        return;
+    }
+    p->was_arrested = false;
+    p->under_sanction = false;
+    advance_turn();
+}
+
+// Mirrors the Player and role methods (and GameState::apply) effect by
+// effect; the differential tests hold the three together.
+void Game::apply_batch(span<const Action> actions) {
+    const size_t n = seat_order.size();
+    Role roles[MAX_PLAYERS];
+    for (size_t i = 0; i < n && i < static_cast<size_t>(MAX_PLAYERS); ++i) {
+        roles[i] = role_from_name(seat_order[i]->role());
+    }
+
+    for (const Action& a : actions) {
+        if (a.actor >= n || active_players.empty() || seat_order[a.actor] != active_players[current_turn_index]
+            || (needs_target(a.type) && (a.target >= n || !seat_order[a.target]->is_active))) {
+            throw runtime_error("Batch action out of turn: " + describe(a));
+        }
+        Player* p = seat_order[a.actor];
+        Player* t = needs_target(a.type) ? seat_order[a.target] : nullptr;
+        log.push_back(a);
+        switch (a.type) {
+            case ActionType::Gather:
+                p->last_action = "gather";
+                p->coin_count += 1;
+                end_turn(p);
+                break;
+            case ActionType::Tax:
+                if (roles[a.actor] == Role::Governor) {
+                    p->coin_count += 3;
+                } else {
+                    p->last_action = "tax";
+                    p->coin_count += 2;
+                }
+                end_turn(p);
+                break;
+            case ActionType::Bribe:
+                p->last_action = "bribe";
+                p->coin_count -= 4;
+                p->used_bribe = true;
+                break;
+            case ActionType::Invest:
+                p->coin_count += 3;
+                end_turn(p);
+                break;
+            case ActionType::Skip:
+                end_turn(p);
+                break;
+            case ActionType::Arrest:
+                p->last_action = "arrest";
+                t->was_arrested = true;
+                if (roles[a.target] == Role::Merchant) {
+                    t->coin_count -= t->coin_count >= 2 ? 2 : t->coin_count;
+                } else if (roles[a.target] != Role::General) {
+                    t->coin_count -= 1;
+                }
+                p->coin_count += 1;
+                p->last_target = t->player_name;
+                end_turn(p);
+                break;
+            case ActionType::Sanction:
+                p->last_action = "sanction";
+                p->coin_count -= 3;
+                t->under_sanction = true;
+                if (roles[a.target] == Role::Baron) t->coin_count += 1;
+                if (roles[a.target] == Role::Judge) p->coin_count -= 1;
+                end_turn(p);
+                break;
+            case ActionType::Coup:
+                p->coin_count -= 7;
+                if (roles[a.target] == Role::General && t->coin_count >= 5) {
+                    t->coin_count -= 5;
+                } else {
+                    t->is_active = false;
+                    eliminate(t);
+                }
+                advance_turn();
+                p->last_action = "coup";
+                break;
+            case ActionType::SpyOn:
+                t->was_arrested = true;
+                break;
+            case ActionType::Undo:
+                t->coin_count -= 2;
+                t->last_action.clear();
+                break;
+        }
+    }
+}
+
 } // namespace coup
\ No newline at end of file
@@ -0,0 +1,105 @@
+// Email: adhamhamoudy3@gmail.com
+#include "GameBridge.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+#include "Governor.hpp"
+#include "Spy.hpp"
+#include "Baron.hpp"
+#include "General.hpp"
+#include "Judge.hpp"
+#include "Merchant.hpp"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+uint8_t last_action_code(const string& action) {
+    if (action == "gather") return static_cast<uint8_t>(ActionType::Gather);
+    if (action == "tax") return static_cast<uint8_t>(ActionType::Tax);
+    if (action == "bribe") return static_cast<uint8_t>(ActionType::Bribe);
+    if (action == "arrest") return static_cast<uint8_t>(ActionType::Arrest);
+    if (action == "sanction") return static_cast<uint8_t>(ActionType::Sanction);
+    if (action == "coup") return static_cast<uint8_t>(ActionType::Coup);
+    return NO_ACTION;
+}
+
+} // namespace
+
+Player* create_player(Game& game, Role role, const string& name) {
+    switch (role) {
+        case Role::Governor: return new Governor(game, name);
+        case Role::Spy: return new Spy(game, name);
+        case Role::Baron: return new Baron(game, name);
+        case Role::General: return new General(game, name);
+        case Role::Judge: return new Judge(game, name);
+        case Role::Merchant: return new Merchant(game, name);
+    }
+    throw runtime_error("Invalid role selected.");
+}
+
+GameState state_from_game(const Game& game) {
+    return state_from_players(game, game.player_list());
+}
+
+GameState state_from_players(const Game& game, const vector<Player*>& seats) {
+    if (seats.size() < 2 || seats.size() > static_cast<size_t>(MAX_PLAYERS)) {
+        throw runtime_error("A game needs 2 to 6 players.");
+    }
+    GameState s;
+    s.num_seats = static_cast<uint8_t>(seats.size());
+    s.ply = static_cast<uint16_t>(game.history().size());
+    s.last_target.fill(NO_SEAT);
+    s.last_action.fill(NO_ACTION);
+
+    string turn = game.turn();
+    for (size_t i = 0; i < seats.size(); ++i) {
+        const Player& p = *seats[i];
+        const uint8_t bit = static_cast<uint8_t>(1u << i);
+        s.roles[i] = role_from_name(p.role());
+        s.coins[i] = static_cast<uint8_t>(p.coins());
+        if (p.active()) s.alive |= bit;
+        if (p.is_arrested()) s.arrested |= bit;
+        if (p.is_sanctioned()) s.sanctioned |= bit;
+        if (p.has_used_bribe()) s.bribed |= bit;
+        s.last_action[i] = last_action_code(p.get_last_action());
+        if (p.name() == turn) s.to_move = static_cast<uint8_t>(i);
+        for (size_t j = 0; j < seats.size(); ++j) {
+            if (seats[j]->name() == p.get_last_target()) s.last_target[i] = static_cast<uint8_t>(j);
+        }
+    }
+    return s;
+}
+
+void perform(const Action& action, const vector<Player*>& seats) {
+    Player& actor = *seats.at(action.actor);
+    Player* target = needs_target(action.type) ? seats.at(action.target) : nullptr;
+
+    switch (action.type) {
+        case ActionType::Gather: actor.gather(); break;
+        case ActionType::Tax: actor.tax(); break;
+        case ActionType::Bribe: actor.bribe(); break;
+        case ActionType::Skip: actor.end_turn(); break;
+        case ActionType::Arrest: actor.arrest(*target); break;
+        case ActionType::Sanction: actor.sanction(*target); break;
+        case ActionType::Coup: actor.coup(*target); break;
+        case ActionType::Undo: actor.undo(*target); break;
+        case ActionType::Invest: {
+            Baron* baron = dynamic_cast<Baron*>(&actor);
+            if (!baron) throw runtime_error("Not a Baron.");
+            baron->invest();
+            break;
+        }
+        case ActionType::SpyOn: {
+            Spy* spy = dynamic_cast<Spy*>(&actor);
+            if (!spy) throw runtime_error("Not a Spy.");
+            spy->spy_on(*target);
+            break;
+        }
+    }
+}
+
+}
@@ -0,0 +1,263 @@
+// Email: adhamhamoudy3@gmail.com
+#include "GameState.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const char* const ROLE_NAMES[NUM_ROLES] = {
+    "Governor", "Spy", "Baron", "General", "Judge", "Merchant"
+};
+
+const char* const ACTION_NAMES[NUM_ACTION_TYPES] = {
+    "gather", "tax", "bribe", "invest", "skip",
+    "arrest", "sanction", "coup", "spy_on", "undo"
+};
+
+uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+} // namespace
+
+string role_name(Role role) {
+    return ROLE_NAMES[static_cast<int>(role)];
+}
+
+Role role_from_name(const string& name) {
+    for (int r = 0; r < NUM_ROLES; ++r) {
+        if (name == ROLE_NAMES[r]) return static_cast<Role>(r);
+    }
+    throw runtime_error("Unknown role: " + name);
+}
+
+const char* action_name(ActionType type) {
+    return ACTION_NAMES[static_cast<int>(type)];
+}
+
+bool needs_target(ActionType type) {
+    return type >= ActionType::Arrest;
+}
+
+string describe(const Action& action) {
+    string s = to_string(action.actor) + " " + action_name(action.type);
+    if (needs_target(action.type)) s += " " + to_string(action.target);
+    return s;
+}
+
+GameState GameState::initial(const vector<Role>& roles) {
+    if (roles.size() < 2 || roles.size() > static_cast<size_t>(MAX_PLAYERS)) {
+        throw runtime_error("A game needs 2 to 6 players.");
+    }
+    GameState s;
+    s.num_seats = static_cast<uint8_t>(roles.size());
+    s.alive = static_cast<uint8_t>((1u << roles.size()) - 1);
+    s.last_target.fill(NO_SEAT);
+    s.last_action.fill(NO_ACTION);
+    for (size_t i = 0; i < roles.size(); ++i) s.roles[i] = roles[i];
+    return s;
+}
+
+int GameState::alive_count() const {
+    return popcount(static_cast<unsigned>(alive));
+}
+
+int GameState::winner() const {
+    return alive_count() == 1 ? countr_zero(static_cast<unsigned>(alive)) : -1;
+}
+
+bool GameState::is_legal(const Action& a) const {
+    if (a.actor != to_move || !is_alive(a.actor) || is_terminal()) return false;
+    const int me = a.actor;
+    const int c = coins[me];
+    const bool must_coup = c >= 10;
+    const uint8_t bit = static_cast<uint8_t>(1u << me);
+
+    if (!needs_target(a.type)) {
+        switch (a.type) {
+            case ActionType::Gather:
+            case ActionType::Tax: return !must_coup && !(sanctioned & bit);
+            case ActionType::Bribe: return !must_coup && c >= 4;
+            case ActionType::Invest: return !must_coup && roles[me] == Role::Baron && c >= 3;
+            case ActionType::Skip: return !must_coup && (sanctioned & bit);
+            default: return false;
+        }
+    }
+
+    const int t = a.target;
+    if (t >= num_seats || t == me || !is_alive(t)) return false;
+    switch (a.type) {
+        case ActionType::Arrest:
+            return !must_coup && last_target[me] != t && !((arrested >> t) & 1)
+                && (roles[t] == Role::Merchant || coins[t] >= 1);
+        case ActionType::Sanction:
+            return !must_coup && c >= (roles[t] == Role::Judge ? 4 : 3);
+        case ActionType::Coup:
+            return c >= 7;
+        case ActionType::SpyOn:
+            return roles[me] == Role::Spy && !((arrested >> t) & 1);
+        case ActionType::Undo:
+            return roles[me] == Role::Governor && last_action[t] == static_cast<uint8_t>(ActionType::Tax)
+                && coins[t] >= 2;
+        default:
+            return false;
+    }
+}
+
+void GameState::legal_actions(ActionList& out) const {
+    out.clear();
+    if (is_terminal()) return;
+    const uint8_t me = to_move;
+    for (int type = 0; type <= static_cast<int>(ActionType::Skip); ++type) {
+        Action a{static_cast<ActionType>(type), me, NO_SEAT};
+        if (is_legal(a)) out.push_back(a);
+    }
+    for (uint8_t t = 0; t < num_seats; ++t) {
+        if (t == me || !is_alive(t)) continue;
+        for (int type = static_cast<int>(ActionType::Arrest); type < NUM_ACTION_TYPES; ++type) {
+            Action a{static_cast<ActionType>(type), me, t};
+            if (is_legal(a)) out.push_back(a);
+        }
+    }
+}
+
+void GameState::apply(const Action& a) {
+    const int me = a.actor;
+    const int t = a.target;
+    ++ply;
+    switch (a.type) {
+        case ActionType::Gather:
+            coins[me] += 1;
+            last_action[me] = static_cast<uint8_t>(ActionType::Gather);
+            end_turn(me);
+            break;
+        case ActionType::Tax:
+            // Governor::tax pays 3 and, unlike Player::tax, leaves last action alone
+            if (roles[me] == Role::Governor) {
+                coins[me] += 3;
+            } else {
+                coins[me] += 2;
+                last_action[me] = static_cast<uint8_t>(ActionType::Tax);
+            }
+            end_turn(me);
+            break;
+        case ActionType::Bribe:
+            coins[me] -= 4;
+            last_action[me] = static_cast<uint8_t>(ActionType::Bribe);
+            bribed |= static_cast<uint8_t>(1u << me);
+            break;
+        case ActionType::Invest:
+            coins[me] += 3;
+            end_turn(me);
+            break;
+        case ActionType::Skip:
+            end_turn(me);
+            break;
+        case ActionType::Arrest:
+            arrested |= static_cast<uint8_t>(1u << t);
+            if (roles[t] == Role::Merchant) {
+                coins[t] -= coins[t] >= 2 ? 2 : coins[t];
+            } else if (roles[t] != Role::General) {
+                coins[t] -= 1;  // a General takes the coin straight back
+            }
+            coins[me] += 1;
+            last_target[me] = static_cast<uint8_t>(t);
+            last_action[me] = static_cast<uint8_t>(ActionType::Arrest);
+            end_turn(me);
+            break;
+        case ActionType::Sanction:
+            coins[me] -= 3;
+            sanctioned |= static_cast<uint8_t>(1u << t);
+            if (roles[t] == Role::Baron) coins[t] += 1;
+            if (roles[t] == Role::Judge) coins[me] -= 1;
+            last_action[me] = static_cast<uint8_t>(ActionType::Sanction);
+            end_turn(me);
+            break;
+        case ActionType::Coup:
+            coins[me] -= 7;
+            if (roles[t] == Role::General && coins[t] >= 5) {
+                coins[t] -= 5;
+            } else {
+                alive &= static_cast<uint8_t>(~(1u << t));
+            }
+            last_action[me] = static_cast<uint8_t>(ActionType::Coup);
+            advance_turn();  // Game::coup passes the turn without end_turn()
+            break;
+        case ActionType::SpyOn:
+            arrested |= static_cast<uint8_t>(1u << t);
+            break;
+        case ActionType::Undo:
+            coins[t] -= 2;
+            last_action[t] = NO_ACTION;
+            break;
+    }
+}
+
+void GameState::end_turn(int seat) {
+    const uint8_t bit = static_cast<uint8_t>(1u << seat);
+    if (bribed & bit) {
+        bribed &= static_cast<uint8_t>(~bit);  // the bribe buys one more action
+        return;
+    }
+    arrested &= static_cast<uint8_t>(~bit);
+    sanctioned &= static_cast<uint8_t>(~bit);
+    advance_turn();
+}
+
+void GameState::advance_turn() {
+    if (!alive) return;
+    do {
+        to_move = static_cast<uint8_t>((to_move + 1) % num_seats);
+    } while (!is_alive(to_move));
+    if (roles[to_move] == Role::Merchant && coins[to_move] >= 3) {
+        coins[to_move] += 1;
+    }
+}
+
+uint64_t GameState::hash() const {
+    uint64_t h = mix(static_cast<uint64_t>(num_seats)
+                     | static_cast<uint64_t>(to_move) << 8
+                     | static_cast<uint64_t>(alive) << 16
+                     | static_cast<uint64_t>(arrested & alive) << 24
+                     | static_cast<uint64_t>(sanctioned & alive) << 32
+                     | static_cast<uint64_t>(bribed & alive) << 40);
+    for (int i = 0; i < num_seats; ++i) {
+        if (!is_alive(i)) continue;
+        uint64_t seat = static_cast<uint64_t>(i)
+                      | static_cast<uint64_t>(coins[i]) << 8
+                      | static_cast<uint64_t>(roles[i]) << 16
+                      | static_cast<uint64_t>(last_target[i]) << 24
+                      | static_cast<uint64_t>(last_action[i]) << 32;
+        h = mix(h ^ seat);
+    }
+    return h;
+}
+
+string GameState::describe() const {
+    string s = "turn " + to_string(to_move) + ":";
+    for (int i = 0; i < num_seats; ++i) {
+        s += " [" + to_string(i) + " " + role_name(roles[i]);
+        if (!is_alive(i)) {
+            s += " out]";
+            continue;
+        }
+        s += " " + to_string(coins[i]) + "c";
+        if ((arrested >> i) & 1) s += " arrested";
+        if ((sanctioned >> i) & 1) s += " sanctioned";
+        if ((bribed >> i) & 1) s += " bribed";
+        if (last_action[i] != NO_ACTION) s += string(" last=") + ACTION_NAMES[last_action[i]];
+        if (last_target[i] != NO_SEAT) s += " target=" + to_string(last_target[i]);
+        s += "]";
+    }
+    return s;
+}
+
+}
@@ -1,5 +1,6 @@
 // Email: adhamhamoudy3@gmail.com
 #include "Governor.hpp"
+#include "GameState.hpp"
 
 using namespace std;
 
@@ -16,7 +17,8 @@ void Governor::tax() {
         throw runtime_error("You are under sanction and cannot tax.");
     }
     add_coins(3); // Governor gets 3 coins instead of 2
-    end_turn();
+    record(ActionType::Tax);
+    pass_turn();
 }
 
 void Governor::undo(Player& other) {
@@ -31,6 +33,8 @@ void Governor::undo(Player& other) {
         throw runtime_error("Cannot undo: player does not have enough coins to remove.");
     }
     other.remove_coins(2);
+    other.clear_last_action();  // The same tax cannot be undone twice
+    record(ActionType::Undo, &other);
 }
 
 }
@@ -0,0 +1,84 @@
+// Email: adhamhamoudy3@gmail.com
+#include "HeuristicBot.hpp"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+// Coins the actor pays for an action (invest pays 3 to get 6 back).
+int cost(const GameState& s, const Action& a) {
+    switch (a.type) {
+        case ActionType::Bribe: return 4;
+        case ActionType::Invest: return 3;
+        case ActionType::Sanction: return s.roles[a.target] == Role::Judge ? 4 : 3;
+        case ActionType::Coup: return 7;
+        default: return 0;
+    }
+}
+
+} // namespace
+
+// Weights in ActionType order:
+// gather, tax, bribe, invest, skip, arrest, sanction, coup, spy_on, undo
+HeuristicParams HeuristicParams::greedy() {
+    HeuristicParams p;
+    p.action_weight = {3, 5, 0, 4, 0, 2, 1, 100, -1, -1};
+    p.per_target_coin = 1;
+    p.threat_bonus = 5;
+    return p;
+}
+
+HeuristicParams HeuristicParams::economic() {
+    HeuristicParams p;
+    p.action_weight = {3, 6, 0, 8, 0, 1, 0, 2, -1, -1};
+    p.per_target_coin = 0.5f;
+    p.threat_bonus = 3;
+    p.per_coin_spent = 0.5f;
+    return p;
+}
+
+HeuristicParams HeuristicParams::aggressive() {
+    HeuristicParams p;
+    p.action_weight = {2, 3, 0, 3, 0, 6, 5, 100, -1, -1};
+    p.per_target_coin = 1;
+    p.threat_bonus = 4;
+    p.per_coin_spent = 0.2f;
+    return p;
+}
+
+Action heuristic_action(const GameState& state, const HeuristicParams& params, FastRng& rng) {
+    ActionList legal;
+    state.legal_actions(legal);
+    if (params.epsilon > 0 && static_cast<float>(rng.next() >> 40) < params.epsilon * static_cast<float>(1 << 24)) {
+        return legal[static_cast<int>(rng.below(static_cast<uint32_t>(legal.size())))];
+    }
+    int best = 0;
+    float best_score = -1e30f;
+    for (int i = 0; i < legal.size(); ++i) {
+        const Action& a = legal[i];
+        float score = params.action_weight[static_cast<int>(a.type)]
+                    - params.per_coin_spent * static_cast<float>(cost(state, a));
+        if (a.target != NO_SEAT) {
+            score += params.per_target_coin * state.coins[a.target];
+            if (state.coins[a.target] >= 7) score += params.threat_bonus;
+        }
+        if (score > best_score) {
+            best_score = score;
+            best = i;
+        }
+    }
+    return legal[best];
+}
+
+Action HeuristicBot::choose(const GameState& state) {
+    if (state.is_terminal()) {
+        throw runtime_error("No legal actions: the game is over.");
+    }
+    return heuristic_action(state, params, rng);
+}
+
+}
@@ -0,0 +1,218 @@
+// Email: adhamhamoudy3@gmail.com
+#include "IsmctsBot.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const uint32_t NO_NODE = UINT32_MAX;
+
+struct InfoNode {
+    Action action;
+    uint8_t mover = NO_SEAT;
+    uint32_t first_child = NO_NODE;  // children form a linked list, since a
+    uint32_t next_sibling = NO_NODE; // determinization may add new actions
+    uint32_t visits = 0;
+    uint32_t available = 0;          // iterations in which action was legal
+    float value = 0;                 // summed reward of the mover
+};
+
+class InfoSetTree {
+    const MctsConfig& config;
+    const Observation& obs;
+    GameState actual;
+    vector<InfoNode> nodes;
+    vector<uint32_t> path;
+    FastRng rng;
+
+public:
+    InfoSetTree(const MctsConfig& config, const Observation& obs, const GameState& actual, uint64_t seed)
+        : config(config), obs(obs), actual(actual), rng(seed) {
+        nodes.reserve(1 << 16);
+        nodes.emplace_back();
+    }
+
+    void iterate() {
+        GameState state = obs.determinize(actual, rng);
+        uint32_t n = 0;
+        path.clear();
+        path.push_back(0);
+
+        ActionList legal;
+        while (!state.is_terminal()) {
+            state.legal_actions(legal);
+            if (n == 0) {
+                // The move played must be legal at the real table, whatever
+                // this determinization allows
+                ActionList all = legal;
+                legal.clear();
+                for (const Action& a : all) {
+                    if (actual.is_legal(a)) legal.push_back(a);
+                }
+                if (legal.empty()) break;
+            }
+            uint32_t next = descend(n, legal);
+            if (next == NO_NODE) break;  // node budget spent: roll out from here
+            bool fresh = nodes[next].visits == 0;
+            n = next;
+            state.apply(nodes[n].action);
+            path.push_back(n);
+            if (fresh) break;
+        }
+
+        Rewards rewards = rollout(state, config.rollout, config.max_rollout_plies, rng);
+        for (uint32_t i : path) {
+            InfoNode& node = nodes[i];
+            ++node.visits;
+            if (node.mover != NO_SEAT) node.value += rewards[node.mover];
+        }
+    }
+
+    void collect(vector<pair<Action, uint64_t>>& totals) const {
+        for (uint32_t c = nodes[0].first_child; c != NO_NODE; c = nodes[c].next_sibling) {
+            for (auto& [action, count] : totals) {
+                if (action == nodes[c].action) count += nodes[c].visits;
+            }
+        }
+    }
+
+private:
+    // Picks the child to follow among the actions legal in this
+    // determinization: an untried one if there is any, else the best by UCB.
+    uint32_t descend(uint32_t n, const ActionList& legal) {
+        uint32_t found[MAX_ACTIONS];
+        int untried[MAX_ACTIONS];
+        int num_untried = 0;
+        for (int i = 0; i < legal.size(); ++i) {
+            found[i] = NO_NODE;
+            for (uint32_t c = nodes[n].first_child; c != NO_NODE; c = nodes[c].next_sibling) {
+                if (nodes[c].action == legal[i]) {
+                    found[i] = c;
+                    break;
+                }
+            }
+            if (found[i] == NO_NODE) untried[num_untried++] = i;
+        }
+
+        if (num_untried > 0) {
+            if (nodes.size() >= config.max_nodes) return NO_NODE;
+            const Action& a = legal[untried[rng.below(static_cast<uint32_t>(num_untried))]];
+            InfoNode child;
+            child.action = a;
+            child.mover = a.actor;
+            child.available = 1;
+            child.next_sibling = nodes[n].first_child;
+            nodes.push_back(child);
+            nodes[n].first_child = static_cast<uint32_t>(nodes.size() - 1);
+            return nodes[n].first_child;
+        }
+
+        uint32_t best = found[0];
+        double best_score = -1.0;
+        for (int i = 0; i < legal.size(); ++i) {
+            InfoNode& child = nodes[found[i]];
+            ++child.available;
+            double score = child.value / child.visits
+                         + config.exploration * sqrt(log(static_cast<double>(child.available)) / child.visits);
+            if (score > best_score) {
+                best_score = score;
+                best = found[i];
+            }
+        }
+        return best;
+    }
+};
+
+} // namespace
+
+IsmctsBot::IsmctsBot(const MctsConfig& config) : config(config) {
+    if (this->config.seed == 0) this->config.seed = random_device{}();
+    if (this->config.threads == 0) this->config.threads = 1;
+}
+
+void IsmctsBot::on_game_start(const GameState& start, int seat) {
+    obs = Observation(start, seat, config.seed);
+    belief = BeliefTracker(start, seat);
+    observing = true;
+}
+
+void IsmctsBot::on_action(const Action& action, const GameState& after) {
+    if (!observing) return;
+    obs.record(action, after);
+    belief.observe(action, after);
+}
+
+Action IsmctsBot::choose(const GameState& state) {
+    return decide(state, Deadline());
+}
+
+Action IsmctsBot::decide(const GameState& state, Deadline deadline) {
+    if (config.time_ms > 0) deadline = deadline.within(chrono::milliseconds(config.time_ms));
+    int iterations = config.iterations;
+    if (iterations <= 0 && !deadline.has_time_limit()) iterations = 1000;
+
+    ActionList legal;
+    state.legal_actions(legal);
+    if (legal.empty()) {
+        throw runtime_error("No legal actions: the game is over.");
+    }
+    if (!observing || obs.viewer() != state.to_move || obs.ply() != state.ply) {
+        on_game_start(state, state.to_move);
+    }
+    visits.clear();
+    playouts = 0;
+    for (const Action& a : legal) visits.push_back({a, 0});
+    if (legal.size() == 1) return legal[0];
+
+    ++searches;
+    const unsigned threads = config.threads;
+    const int per_thread = iterations > 0
+        ? (iterations + static_cast<int>(threads) - 1) / static_cast<int>(threads)
+        : 0;
+
+    vector<InfoSetTree> trees;
+    trees.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        trees.emplace_back(config, obs, state, config.seed + searches * 0x9e3779b97f4a7c15ULL + t);
+    }
+    atomic<uint64_t> done{0};
+    auto search = [&](InfoSetTree& tree) {
+        int i = 0;
+        for (; per_thread == 0 || i < per_thread; ++i) {
+            if (deadline.expired()) break;
+            tree.iterate();
+        }
+        done += i;
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(search, ref(trees[t]));
+    search(trees[0]);
+    for (auto& t : pool) t.join();
+
+    for (const InfoSetTree& tree : trees) tree.collect(visits);
+    playouts = done;
+
+    const pair<Action, uint64_t>* best = &visits[0];
+    for (const auto& entry : visits) {
+        if (entry.second > best->second) best = &entry;
+    }
+    if (best->second == 0) {
+        // Stopped before any playout finished: the rollout policy's move in
+        // a determinization, so hidden values stay hidden
+        FastRng rng(config.seed + searches);
+        Action a = rollout_action(obs.determinize(state, rng), config.rollout, rng);
+        return state.is_legal(a) ? a : legal[0];
+    }
+    return best->first;
+}
+
+}
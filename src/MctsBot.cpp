@@ -0,0 +1,615 @@
+// Email: adhamhamoudy3@gmail.com
+#include "MctsBot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const uint32_t NO_NODE = UINT32_MAX;
+
+// Deepest the tree is searched for the next position when reusing it: enough
+// for a full round at a six-seat table, with a bribe or a free action.
+const int MAX_REUSE_PLIES = 8;
+
+struct Node {
+    Action action;                   // action that led here
+    uint8_t mover = NO_SEAT;         // seat that played it
+    bool expanded = false;
+    bool in_use = false;
+    uint8_t pins = 0;                // searches in flight through this node
+    uint32_t first_child = NO_NODE;  // children form a linked list so that
+    uint32_t next_sibling = NO_NODE; // single nodes can be recycled
+    uint32_t visits = 0;
+    float value = 0;                 // summed reward of the mover
+};
+
+} // namespace
+
+// One search tree (root parallelization runs one per thread). Nodes live in
+// a pool that never grows past `capacity`; when it is full, the least-visited
+// subtrees are cut back to leaves and their nodes reused. The tree is kept
+// between decisions and re-rooted at the position reached.
+class SearchTree {
+    const MctsConfig& config;
+    GameState root_state;
+    uint32_t root = NO_NODE;
+    size_t capacity;
+    vector<Node> nodes;
+    uint32_t free_list = NO_NODE;  // linked through next_sibling
+    size_t free_count = 0;
+    vector<uint32_t> path;
+    vector<uint32_t> batch_paths;  // paths of one batch, back to back
+    vector<size_t> batch_ends;
+    FastRng rng;
+
+public:
+    SearchTree(const MctsConfig& config, size_t capacity, uint64_t seed)
+        : config(config), capacity(capacity), rng(seed) {
+        nodes.reserve(capacity < (1 << 16) ? capacity : (1 << 16));
+    }
+
+    void reseed(uint64_t seed) { rng = FastRng(seed); }
+
+    void clear() {
+        if (root != NO_NODE) release(root);
+        root = NO_NODE;
+    }
+
+    // Makes state the root, keeping the matching subtree if the position is
+    // a few plies below the current root, else starting over.
+    void set_root(const GameState& state) {
+        uint32_t keep = NO_NODE;
+        if (root != NO_NODE && state.ply >= root_state.ply && state.ply - root_state.ply <= MAX_REUSE_PLIES) {
+            keep = find(root, root_state, state);
+        }
+        if (keep == NO_NODE) {
+            if (root != NO_NODE) release(root);
+            keep = allocate();
+        } else if (keep != root) {
+            release_except(root, keep);
+            nodes[keep].next_sibling = NO_NODE;
+        }
+        root = keep;
+        root_state = state;
+    }
+
+    size_t nodes_in_use() const { return nodes.size() - free_count; }
+
+    void iterate() {
+        GameState state = root_state;
+        descend(state, path, false);
+        backup(path, rollout(state, config.rollout, config.max_rollout_plies, rng));
+    }
+
+    // Runs count iterations (at most EVAL_BATCH) whose leaves are scored by
+    // one call to the evaluator. Visits are added on the way down so the
+    // searches in a batch spread out (virtual loss).
+    void iterate_batch(int count, const LinearEvaluator& evaluator) {
+        GameState leaves[EVAL_BATCH];
+        Rewards rewards[EVAL_BATCH];
+        batch_paths.clear();
+        batch_ends.clear();
+        for (int b = 0; b < count; ++b) {
+            leaves[b] = root_state;
+            descend(leaves[b], batch_paths, true);
+            batch_ends.push_back(batch_paths.size());
+        }
+        evaluator.evaluate_batch(leaves, count, rewards);
+        size_t begin = 0;
+        for (int b = 0; b < count; ++b) {
+            if (leaves[b].is_terminal()) rewards[b] = final_rewards(leaves[b]);
+            for (size_t k = begin; k < batch_ends[b]; ++k) {
+                Node& node = nodes[batch_paths[k]];
+                --node.pins;
+                if (node.mover != NO_SEAT) node.value += rewards[b][node.mover];
+            }
+            begin = batch_ends[b];
+        }
+    }
+
+    // Adds this tree's root visit counts into totals (same order as legal_actions).
+    void collect(vector<pair<Action, uint64_t>>& totals) const {
+        for (uint32_t c = nodes[root].first_child; c != NO_NODE; c = nodes[c].next_sibling) {
+            for (auto& [action, count] : totals) {
+                if (action == nodes[c].action) count += nodes[c].visits;
+            }
+        }
+    }
+
+private:
+    // Walks from the root to a leaf, expanding it and stepping to a random
+    // child, and appends the nodes to out. They stay pinned (safe from
+    // recycling) until backed up; with `visit` they also count as visited
+    // right away.
+    void descend(GameState& state, vector<uint32_t>& out, bool visit) {
+        uint32_t n = root;
+        pin(n, visit);
+        out.push_back(n);
+        while (nodes[n].expanded && nodes[n].first_child != NO_NODE) {
+            n = select(n);
+            state.apply(nodes[n].action);
+            pin(n, visit);
+            out.push_back(n);
+        }
+        if (!nodes[n].expanded && !state.is_terminal() && expand(n, state)) {
+            uint32_t pick = rng.below(count_children(n));
+            n = nodes[n].first_child;
+            while (pick--) n = nodes[n].next_sibling;
+            state.apply(nodes[n].action);
+            pin(n, visit);
+            out.push_back(n);
+        }
+    }
+
+    void pin(uint32_t n, bool visit) {
+        ++nodes[n].pins;
+        if (visit) ++nodes[n].visits;
+    }
+
+    void backup(vector<uint32_t>& nodes_on_path, const Rewards& rewards) {
+        for (uint32_t i : nodes_on_path) {
+            Node& node = nodes[i];
+            --node.pins;
+            ++node.visits;
+            if (node.mover != NO_SEAT) node.value += rewards[node.mover];
+        }
+        nodes_on_path.clear();
+    }
+
+    uint32_t select(uint32_t n) {
+        double log_n = log(static_cast<double>(nodes[n].visits) + 1.0);
+        uint32_t best = nodes[n].first_child;
+        double best_score = -1.0;
+        for (uint32_t c = nodes[n].first_child; c != NO_NODE; c = nodes[c].next_sibling) {
+            const Node& child = nodes[c];
+            if (child.visits == 0) return c;
+            double score = child.value / child.visits
+                         + config.exploration * sqrt(log_n / child.visits);
+            if (score > best_score) {
+                best_score = score;
+                best = c;
+            }
+        }
+        return best;
+    }
+
+    uint32_t count_children(uint32_t n) const {
+        uint32_t count = 0;
+        for (uint32_t c = nodes[n].first_child; c != NO_NODE; c = nodes[c].next_sibling) ++count;
+        return count;
+    }
+
+    // Returns false, leaving n a leaf for this iteration, if even recycling
+    // cannot make room for its children.
+    bool expand(uint32_t n, const GameState& state) {
+        ActionList legal;
+        state.legal_actions(legal);
+        size_t needed = static_cast<size_t>(legal.size());
+        if (free_count + (capacity - nodes.size()) < needed && !recycle(needed)) return false;
+
+        // Link in reverse so the children keep legal_actions order
+        uint32_t first = NO_NODE;
+        for (int i = legal.size() - 1; i >= 0; --i) {
+            uint32_t c = allocate();
+            nodes[c].action = legal[i];
+            nodes[c].mover = legal[i].actor;
+            nodes[c].next_sibling = first;
+            first = c;
+        }
+        nodes[n].first_child = first;
+        nodes[n].expanded = true;
+        return true;
+    }
+
+    uint32_t allocate() {
+        uint32_t n;
+        if (free_list != NO_NODE) {
+            n = free_list;
+            free_list = nodes[n].next_sibling;
+            --free_count;
+            nodes[n] = Node();
+        } else {
+            n = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        nodes[n].in_use = true;
+        return n;
+    }
+
+    void free_node(uint32_t n) {
+        nodes[n].in_use = false;
+        nodes[n].next_sibling = free_list;
+        free_list = n;
+        ++free_count;
+    }
+
+    // Frees all descendants of n and turns it back into a leaf.
+    void collapse(uint32_t n) {
+        uint32_t c = nodes[n].first_child;
+        while (c != NO_NODE) {
+            uint32_t next = nodes[c].next_sibling;
+            release(c);
+            c = next;
+        }
+        nodes[n].first_child = NO_NODE;
+        nodes[n].expanded = false;
+    }
+
+    void release(uint32_t n) {
+        collapse(n);
+        free_node(n);
+    }
+
+    // Frees the tree under n except the subtree rooted at keep.
+    void release_except(uint32_t n, uint32_t keep) {
+        uint32_t c = nodes[n].first_child;
+        while (c != NO_NODE) {
+            uint32_t next = nodes[c].next_sibling;
+            if (c != keep) release_except(c, keep);
+            c = next;
+        }
+        free_node(n);
+    }
+
+    // Cuts the least-visited subtrees (never the root or a pinned node)
+    // back to leaves until at least a quarter of the pool is free.
+    bool recycle(size_t needed) {
+        size_t target = max(needed, capacity / 4);
+        vector<pair<uint32_t, uint32_t>> candidates;  // (visits, node)
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].in_use && nodes[i].expanded && i != root) candidates.push_back({nodes[i].visits, i});
+        }
+        sort(candidates.begin(), candidates.end());
+        for (const auto& [v, i] : candidates) {
+            if (free_count >= target) break;
+            if (!nodes[i].in_use || !nodes[i].expanded) continue;  // inside a subtree already cut
+            if (nodes[i].pins > 0) continue;
+            collapse(i);
+        }
+        return free_count + (capacity - nodes.size()) >= needed;
+    }
+
+    // Node below n (whose position is state) reached at target, if any.
+    uint32_t find(uint32_t n, const GameState& state, const GameState& target) const {
+        if (state.ply == target.ply) {
+            return state.to_move == target.to_move && state.hash() == target.hash() ? n : NO_NODE;
+        }
+        for (uint32_t c = nodes[n].first_child; c != NO_NODE; c = nodes[c].next_sibling) {
+            GameState next = state;
+            next.apply(nodes[c].action);
+            uint32_t found = find(c, next, target);
+            if (found != NO_NODE) return found;
+        }
+        return NO_NODE;
+    }
+};
+
+namespace {
+
+// Node of the shared tree. Counters are atomics; children are carved out of
+// a preallocated pool by whichever thread wins the CAS on `state`.
+struct SharedNode {
+    enum : uint8_t { LEAF, EXPANDING, EXPANDED };
+
+    Action action;
+    uint8_t mover = NO_SEAT;
+    uint8_t num_children = 0;
+    atomic<uint8_t> state{LEAF};
+    uint32_t first_child = 0;
+    atomic<uint32_t> visits{0};  // includes virtual visits of searches in flight
+    atomic<float> value{0};
+};
+
+// One tree searched by all threads at once (tree parallelization).
+class SharedTree {
+    static constexpr size_t MIN_POOL = 1 + MAX_ACTIONS;  // room to expand the root
+
+    const MctsConfig& config;
+    GameState root_state;
+    unique_ptr<SharedNode[]> pool;
+    size_t capacity;
+    atomic<size_t> used{1};
+
+public:
+    SharedTree(const MctsConfig& config, const GameState& root)
+        : config(config), root_state(root),
+          capacity(config.max_nodes > MIN_POOL ? config.max_nodes : MIN_POOL) {
+        pool.reset(new SharedNode[capacity]);
+    }
+
+    void iterate(FastRng& rng, vector<uint32_t>& path) {
+        const uint32_t loss = static_cast<uint32_t>(config.virtual_loss);
+        GameState state = root_state;
+        uint32_t n = 0;
+        path.clear();
+        path.push_back(0);
+        pool[0].visits.fetch_add(loss, memory_order_relaxed);
+
+        while (pool[n].state.load(memory_order_acquire) == SharedNode::EXPANDED
+               && pool[n].num_children > 0) {
+            n = select(n);
+            pool[n].visits.fetch_add(loss, memory_order_relaxed);
+            state.apply(pool[n].action);
+            path.push_back(n);
+        }
+        if (!state.is_terminal() && try_expand(n, state)) {
+            n = pool[n].first_child + rng.below(pool[n].num_children);
+            pool[n].visits.fetch_add(loss, memory_order_relaxed);
+            state.apply(pool[n].action);
+            path.push_back(n);
+        }
+
+        Rewards rewards = rollout(state, config.rollout, config.max_rollout_plies, rng);
+        for (uint32_t i : path) {
+            SharedNode& node = pool[i];
+            // Turn the virtual visits into one real one
+            if (loss != 1) node.visits.fetch_add(1 - loss, memory_order_relaxed);
+            if (node.mover != NO_SEAT) node.value.fetch_add(rewards[node.mover], memory_order_relaxed);
+        }
+    }
+
+    void collect(vector<pair<Action, uint64_t>>& totals) const {
+        const SharedNode& root = pool[0];
+        if (root.state.load(memory_order_acquire) != SharedNode::EXPANDED) return;
+        for (uint32_t c = root.first_child; c < root.first_child + root.num_children; ++c) {
+            for (auto& [action, count] : totals) {
+                if (action == pool[c].action) count += pool[c].visits.load(memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    uint32_t select(uint32_t n) const {
+        const SharedNode& parent = pool[n];
+        double log_n = log(static_cast<double>(parent.visits.load(memory_order_relaxed)) + 1.0);
+        uint32_t best = parent.first_child;
+        double best_score = -1.0;
+        for (uint32_t c = parent.first_child; c < parent.first_child + parent.num_children; ++c) {
+            const SharedNode& child = pool[c];
+            uint32_t v = child.visits.load(memory_order_relaxed);
+            if (v == 0) return c;
+            double score = child.value.load(memory_order_relaxed) / v
+                         + config.exploration * sqrt(log_n / v);
+            if (score > best_score) {
+                best_score = score;
+                best = c;
+            }
+        }
+        return best;
+    }
+
+    // Returns true once n has children. A thread that loses the race, or
+    // finds the pool exhausted, simply rolls out from n as a leaf.
+    bool try_expand(uint32_t n, const GameState& state) {
+        SharedNode& node = pool[n];
+        uint8_t expected = SharedNode::LEAF;
+        if (!node.state.compare_exchange_strong(expected, SharedNode::EXPANDING, memory_order_acq_rel)) {
+            return expected == SharedNode::EXPANDED && node.num_children > 0;
+        }
+        ActionList legal;
+        state.legal_actions(legal);
+        size_t first = used.fetch_add(legal.size(), memory_order_relaxed);
+        if (first + legal.size() > capacity) {
+            // Out of nodes: n stays a leaf for good (expanded, no children)
+            node.state.store(SharedNode::EXPANDED, memory_order_release);
+            return false;
+        }
+        for (int i = 0; i < legal.size(); ++i) {
+            pool[first + i].action = legal[i];
+            pool[first + i].mover = legal[i].actor;
+        }
+        node.first_child = static_cast<uint32_t>(first);
+        node.num_children = static_cast<uint8_t>(legal.size());
+        node.state.store(SharedNode::EXPANDED, memory_order_release);
+        return true;
+    }
+};
+
+} // namespace
+
+MctsBot::MctsBot(const MctsConfig& config) : config(config) {
+    if (this->config.seed == 0) this->config.seed = random_device{}();
+    if (this->config.threads == 0) this->config.threads = 1;
+}
+
+MctsBot::~MctsBot() {
+    stop_pondering();
+}
+
+size_t MctsBot::nodes_in_use() const {
+    size_t total = 0;
+    for (const auto& tree : trees) total += tree->nodes_in_use();
+    return total;
+}
+
+Action MctsBot::choose(const GameState& state) {
+    return decide(state, Deadline());
+}
+
+Action MctsBot::decide(const GameState& state, Deadline deadline) {
+    stop_pondering();
+    pondered = ponder_playouts;
+    ponder_playouts = 0;
+    Action action = search(state, deadline);
+    if (config.ponder) {
+        GameState next = state;
+        next.apply(action);
+        ponder(next);
+    }
+    return action;
+}
+
+void MctsBot::on_game_start(const GameState& /*start*/, int /*seat*/) {
+    stop_pondering();
+    for (auto& tree : trees) tree->clear();
+}
+
+void MctsBot::on_action(const Action& /*action*/, const GameState& after) {
+    if (!pondering()) return;
+    stop_pondering();
+    ponder(after);
+}
+
+void MctsBot::ponder(const GameState& state) {
+    stop_pondering();
+    if (state.is_terminal() || config.parallelism != Parallelism::Root || !config.reuse_tree) return;
+    ++searches;
+    prepare_trees(state);
+    ponder_stop.store(false);
+    ponder_thread = thread([this] {
+        Deadline until_stopped;
+        until_stopped.cancel_on(ponder_stop);
+        ponder_playouts += run_trees(0, until_stopped);
+    });
+}
+
+void MctsBot::stop_pondering() {
+    if (!ponder_thread.joinable()) return;
+    ponder_stop.store(true);
+    ponder_thread.join();
+}
+
+Action MctsBot::search(const GameState& state, Deadline deadline) {
+    if (config.time_ms > 0) deadline = deadline.within(chrono::milliseconds(config.time_ms));
+    // With neither a time limit nor an iteration budget, fall back to 1000
+    int iterations = config.iterations;
+    if (iterations <= 0 && !deadline.has_time_limit()) iterations = 1000;
+
+    ActionList legal;
+    state.legal_actions(legal);
+    if (legal.empty()) {
+        throw runtime_error("No legal actions: the game is over.");
+    }
+    visits.clear();
+    playouts = 0;
+    for (const Action& a : legal) visits.push_back({a, 0});
+    endgame_result = AlphaBetaResult();
+    if (legal.size() == 1) return legal[0];
+
+    Action won;
+    if (config.book && config.book->lookup(state, won)) return won;
+    if (config.tablebase && config.tablebase->best_action(state, won)) return won;
+    if (config.endgame_depth > 0 && state.alive_count() == 2) {
+        if (!endgame) {
+            AlphaBetaConfig ab;
+            ab.max_depth = config.endgame_depth;
+            ab.threads = config.threads;
+            endgame = make_unique<AlphaBeta>(ab);
+        }
+        endgame_result = endgame->search(state, deadline.share(0.5));
+        if (endgame_result.proven() && endgame_result.score > 0) return endgame_result.best;
+    }
+
+    ++searches;
+    if (config.parallelism == Parallelism::Tree) {
+        search_tree_parallel(state, iterations, deadline);
+    } else {
+        search_root_parallel(state, iterations, deadline);
+    }
+
+    const pair<Action, uint64_t>* best = &visits[0];
+    for (const auto& entry : visits) {
+        if (entry.second > best->second) best = &entry;
+    }
+    if (best->second == 0) {
+        // Stopped before any playout finished: the rollout policy's move
+        FastRng rng(config.seed + searches);
+        return rollout_action(state, config.rollout, rng);
+    }
+    return best->first;
+}
+
+void MctsBot::search_root_parallel(const GameState& state, int iterations, const Deadline& deadline) {
+    prepare_trees(state);
+    playouts = run_trees(iterations, deadline);
+    for (const auto& tree : trees) tree->collect(visits);
+}
+
+// Creates the trees on first use, then roots them at state.
+void MctsBot::prepare_trees(const GameState& state) {
+    const unsigned threads = config.threads;
+
+    // The node cap is shared between the trees
+    if (trees.size() != threads) {
+        const size_t min_pool = 1 + MAX_ACTIONS;
+        size_t per_tree = max(config.max_nodes / threads, min_pool);
+        trees.clear();
+        for (unsigned t = 0; t < threads; ++t) trees.push_back(make_unique<SearchTree>(config, per_tree, 0));
+    }
+    for (unsigned t = 0; t < threads; ++t) {
+        SearchTree& tree = *trees[t];
+        if (!config.reuse_tree) tree.clear();
+        tree.set_root(state);
+        tree.reseed(config.seed + searches * 0x9e3779b97f4a7c15ULL + t);
+    }
+}
+
+// Searches every tree on its own thread; returns the playouts run.
+uint64_t MctsBot::run_trees(int iterations, const Deadline& deadline) {
+    const unsigned threads = config.threads;
+    const int per_thread = iterations > 0
+        ? (iterations + static_cast<int>(threads) - 1) / static_cast<int>(threads)
+        : 0;
+    atomic<uint64_t> done{0};
+    auto search = [&](SearchTree& tree) {
+        int i = 0;
+        if (config.evaluator) {
+            while (per_thread == 0 || i < per_thread) {
+                if (deadline.expired()) break;
+                int batch = per_thread == 0 ? EVAL_BATCH : min(EVAL_BATCH, per_thread - i);
+                tree.iterate_batch(batch, *config.evaluator);
+                i += batch;
+            }
+        } else {
+            // Checked every iteration: a clock read costs far less than a rollout
+            for (; per_thread == 0 || i < per_thread; ++i) {
+                if (deadline.expired()) break;
+                tree.iterate();
+            }
+        }
+        done += i;
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(search, ref(*trees[t]));
+    search(*trees[0]);
+    for (auto& t : pool) t.join();
+    return done;
+}
+
+void MctsBot::search_tree_parallel(const GameState& state, int iterations, const Deadline& deadline) {
+    SharedTree tree(config, state);
+    atomic<int64_t> remaining{iterations > 0 ? iterations : INT64_MAX};
+    atomic<uint64_t> done{0};
+
+    auto search = [&](unsigned t) {
+        FastRng rng(config.seed + searches * 0x9e3779b97f4a7c15ULL + t);
+        vector<uint32_t> path;
+        uint64_t i = 0;
+        while (remaining.fetch_sub(1, memory_order_relaxed) > 0) {
+            if (deadline.expired()) break;
+            tree.iterate(rng, path);
+            ++i;
+        }
+        done += i;
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < config.threads; ++t) pool.emplace_back(search, t);
+    search(0);
+    for (auto& t : pool) t.join();
+
+    tree.collect(visits);
+    playouts = done;
+}
+
+}
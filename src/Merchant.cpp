@@ -25,10 +25,9 @@ void Merchant::on_arrested_by(Player& by) {
     }
 }
 
-void Merchant::validate_turn() const {
-    Player::validate_turn();
-    // Grants +1 coin bonus if 3 or more coins at start of turn
-    const_cast<Merchant*>(this)->start_turn_bonus();
+void Merchant::start_turn() {
+    // Grants +1 coin bonus once, when the turn passes to the Merchant
+    start_turn_bonus();
 }
 
 }
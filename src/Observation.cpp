@@ -0,0 +1,140 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Observation.hpp"
+
+#include <bit>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const uint8_t ALL_ROLES = (1u << NUM_ROLES) - 1;
+const int REFILL_ATTEMPTS = 200 * Observation::PARTICLES;
+
+uint8_t role_bit(Role r) {
+    return static_cast<uint8_t>(1u << static_cast<int>(r));
+}
+
+} // namespace
+
+Observation::Observation(const GameState& start, int viewer, uint64_t seed)
+    : seat(viewer), start_public(start), own_role(start.roles[viewer]), rng(seed) {
+    for (int i = 0; i < start_public.num_seats; ++i) {
+        if (i != seat) start_public.roles[i] = Role::Governor;  // hidden; never read
+    }
+    refill();
+}
+
+bool Observation::consistent(const GameState& state, const Step& step) const {
+    return state.alive == step.alive_after
+        && (step.revealed_coins < 0 || state.coins[step.action.target] == step.revealed_coins);
+}
+
+bool Observation::replay(GameState& state) const {
+    for (const Step& step : history) {
+        if (!state.is_legal(step.action)) return false;
+        state.apply(step.action);
+        if (!consistent(state, step)) return false;
+    }
+    return true;
+}
+
+// Rejection-samples fresh particles: hidden roles are drawn from the roles
+// still possible for each seat, then the whole history is replayed.
+void Observation::refill() {
+    array<uint8_t, MAX_PLAYERS> possible{};
+    for (int i = 0; i < start_public.num_seats; ++i) possible[i] = evidence_roles(i);
+
+    for (int attempt = 0; attempt < REFILL_ATTEMPTS && particles.size() < PARTICLES; ++attempt) {
+        GameState s = start_public;
+        for (int i = 0; i < s.num_seats; ++i) {
+            if (i == seat) {
+                s.roles[i] = own_role;
+                continue;
+            }
+            uint8_t mask = possible[i] ? possible[i] : ALL_ROLES;
+            int options = popcount(static_cast<unsigned>(mask));
+            int pick = static_cast<int>(rng.below(static_cast<uint32_t>(options)));
+            for (int r = 0; r < NUM_ROLES; ++r) {
+                if (((mask >> r) & 1) && pick-- == 0) s.roles[i] = static_cast<Role>(r);
+            }
+        }
+        if (replay(s)) particles.push_back(s);
+    }
+}
+
+void Observation::record(const Action& action, const GameState& after) {
+    Step step{action, after.alive, -1};
+    if (action.type == ActionType::SpyOn && action.actor == seat) {
+        step.revealed_coins = after.coins[action.target];
+    }
+    history.push_back(step);
+
+    vector<GameState> survivors;
+    survivors.reserve(particles.size());
+    for (GameState s : particles) {
+        if (!s.is_legal(action)) continue;
+        s.apply(action);
+        if (consistent(s, step)) survivors.push_back(s);
+    }
+
+    if (survivors.size() < PARTICLES / 2) {
+        vector<GameState> previous = particles;
+        particles = survivors;
+        refill();
+        if (particles.empty()) {
+            // Nothing consistent found this time: keep the old particles and
+            // follow the public outcome, so search still has something to use
+            for (GameState s : previous) {
+                if (s.is_legal(action)) s.apply(action);
+                s.alive = step.alive_after;
+                particles.push_back(s);
+            }
+        }
+    } else {
+        particles = move(survivors);
+    }
+}
+
+GameState Observation::determinize(const GameState& actual, FastRng& rng) const {
+    const GameState& p = particles.empty()
+        ? start_public
+        : particles[rng.below(static_cast<uint32_t>(particles.size()))];
+    GameState s = actual;
+    for (int i = 0; i < s.num_seats; ++i) {
+        if (i == seat) continue;
+        s.roles[i] = p.roles[i];
+        s.coins[i] = p.coins[i];
+        s.last_action[i] = p.last_action[i];  // a Governor's tax leaves it unset
+    }
+    return s;
+}
+
+uint8_t Observation::possible_roles(int s) const {
+    if (s == seat) return role_bit(own_role);
+    uint8_t mask = 0;
+    for (const GameState& p : particles) mask |= role_bit(p.roles[s]);
+    return mask ? mask : evidence_roles(s);
+}
+
+// Roles that only one role can explain: invest, spy_on, undo, and
+// surviving a coup (a General's block).
+uint8_t Observation::evidence_roles(int s) const {
+    if (s == seat) return role_bit(own_role);
+    uint8_t mask = ALL_ROLES;
+    for (const Step& step : history) {
+        const Action& a = step.action;
+        if (a.actor == s) {
+            if (a.type == ActionType::Invest) mask &= role_bit(Role::Baron);
+            if (a.type == ActionType::SpyOn) mask &= role_bit(Role::Spy);
+            if (a.type == ActionType::Undo) mask &= role_bit(Role::Governor);
+        }
+        if (a.type == ActionType::Coup && a.target == s && ((step.alive_after >> s) & 1)) {
+            mask &= role_bit(Role::General);
+        }
+    }
+    return mask;
+}
+
+}
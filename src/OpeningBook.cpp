@@ -0,0 +1,232 @@
+// Email: adhamhamoudy3@gmail.com
+#include "OpeningBook.hpp"
+#include "MctsBot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'O', 'U', 'P', 'B', 'O', 'O', 'K'};
+const uint32_t FORMAT_VERSION = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t rules_version;
+    uint32_t num_seats;
+    uint32_t plies;
+    uint64_t entries;
+    uint8_t padding[32];
+};
+static_assert(sizeof(Header) == 64, "book header must stay 64 bytes");
+
+struct Entry {
+    uint64_t key;
+    uint8_t type;
+    uint8_t actor;
+    uint8_t target;
+    uint8_t reserved;
+    float share;  // fraction of the summed root visits the move got
+};
+static_assert(sizeof(Entry) == 16, "book entries must stay 16 bytes");
+
+struct Position {
+    GameState state;
+    int hits = 0;
+};
+
+// Positions reached in the first config.plies plies of sampled openings.
+vector<GameState> collect_positions(const OpeningBookConfig& config) {
+    static const RolloutPolicy POLICIES[] = {RolloutPolicy::Greedy, RolloutPolicy::Economic,
+                                             RolloutPolicy::Aggressive, RolloutPolicy::Heuristic};
+    FastRng rng(config.seed);
+    unordered_map<uint64_t, Position> seen;
+    for (int g = 0; g < config.sample_games; ++g) {
+        vector<Role> roles(static_cast<size_t>(config.num_seats));
+        for (Role& r : roles) r = static_cast<Role>(rng.below(NUM_ROLES));
+        RolloutPolicy styles[MAX_PLAYERS];
+        for (int i = 0; i < config.num_seats; ++i) styles[i] = POLICIES[rng.below(4)];
+
+        GameState s = GameState::initial(roles);
+        while (s.ply < config.plies && !s.is_terminal()) {
+            Position& p = seen[OpeningBook::key(s)];
+            if (p.hits++ == 0) p.state = s;
+            s.apply(rollout_action(s, styles[s.to_move], rng));
+        }
+    }
+    vector<GameState> positions;
+    for (const auto& [key, p] : seen) {
+        if (p.hits >= config.min_hits) positions.push_back(p.state);
+    }
+    return positions;
+}
+
+// Book move for a position: root visits of one search per deal of the
+// other seats' roles, summed per action.
+Entry search_position(const GameState& state, const OpeningBookConfig& config, uint64_t seed) {
+    ActionList legal;
+    state.legal_actions(legal);
+    vector<uint64_t> total(static_cast<size_t>(legal.size()), 0);
+    FastRng rng(seed);
+    for (int d = 0; d < config.deals; ++d) {
+        GameState deal = state;
+        for (int i = 0; i < deal.num_seats; ++i) {
+            if (i != state.to_move) deal.roles[i] = static_cast<Role>(rng.below(NUM_ROLES));
+        }
+        MctsConfig mc;
+        mc.iterations = config.iterations;
+        mc.seed = rng.next() | 1;
+        MctsBot bot(mc);
+        bot.choose(deal);
+        for (const auto& [action, visits] : bot.last_visits()) {
+            for (int i = 0; i < legal.size(); ++i) {
+                if (legal[i] == action) total[i] += visits;
+            }
+        }
+    }
+    int best = 0;
+    uint64_t sum = 0;
+    for (int i = 0; i < legal.size(); ++i) {
+        sum += total[i];
+        if (total[i] > total[best]) best = i;
+    }
+    Entry e{};
+    e.key = OpeningBook::key(state);
+    e.type = static_cast<uint8_t>(legal[best].type);
+    e.actor = legal[best].actor;
+    e.target = legal[best].target;
+    e.share = sum ? static_cast<float>(total[best]) / static_cast<float>(sum) : 1.0f;
+    return e;
+}
+
+} // namespace
+
+uint64_t build_opening_book(const string& path, const OpeningBookConfig& config, ostream* progress) {
+    if (config.num_seats < 2 || config.num_seats > MAX_PLAYERS || config.plies < 1) {
+        throw runtime_error("Opening book needs 2-6 seats and at least one ply.");
+    }
+    vector<GameState> positions = collect_positions(config);
+    if (progress) *progress << positions.size() << " positions to search" << endl;
+
+    vector<Entry> entries(positions.size());
+    atomic<size_t> next{0};
+    atomic<size_t> done{0};
+    const size_t report_every = max<size_t>(positions.size() / 10, 1);
+    auto work = [&] {
+        for (size_t i; (i = next.fetch_add(1)) < positions.size();) {
+            entries[i] = search_position(positions[i], config, config.seed * 0x9e3779b97f4a7c15ULL + i);
+            size_t n = ++done;
+            if (progress && n % report_every == 0) {
+                *progress << "searched " << n << "/" << positions.size() << endl;
+            }
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < config.threads; ++t) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+
+    sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+    // Written beside the target and renamed, so a reader never maps half a book
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.rules_version = RULES_VERSION;
+    header.num_seats = static_cast<uint32_t>(config.num_seats);
+    header.plies = static_cast<uint32_t>(config.plies);
+    header.entries = entries.size();
+    const string tmp = path + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()),
+                  static_cast<streamsize>(entries.size() * sizeof(Entry)));
+        if (!out) throw runtime_error("Cannot write " + tmp);
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) throw runtime_error("Cannot write " + path);
+    return entries.size();
+}
+
+OpeningBook::OpeningBook(const string& path) {
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Cannot open " + path);
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        unmap();
+        throw runtime_error("Cannot stat " + path);
+    }
+    map_size = static_cast<size_t>(st.st_size);
+    if (map_size >= sizeof(Header)) {
+        map = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) map = nullptr;
+    }
+    const Header* header = static_cast<const Header*>(map);
+    if (!header || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+        || header->format_version != FORMAT_VERSION
+        || header->entries > (map_size - sizeof(Header)) / sizeof(Entry)
+        || map_size != sizeof(Header) + header->entries * sizeof(Entry)) {
+        unmap();
+        throw runtime_error(path + " is not an opening book.");
+    }
+    if (header->rules_version != RULES_VERSION) {
+        unmap();
+        throw runtime_error(path + " was built for other rules.");
+    }
+    entries = static_cast<const uint8_t*>(map) + sizeof(Header);
+    count = header->entries;
+    max_ply = static_cast<int>(header->plies);
+}
+
+OpeningBook::~OpeningBook() {
+    unmap();
+}
+
+void OpeningBook::unmap() {
+    if (map) munmap(map, map_size);
+    if (fd >= 0) close(fd);
+    map = nullptr;
+    fd = -1;
+}
+
+uint64_t OpeningBook::key(const GameState& state) {
+    GameState masked = state;
+    for (int i = 0; i < masked.num_seats; ++i) {
+        if (i != masked.to_move) masked.roles[i] = Role::Governor;
+    }
+    return masked.hash();
+}
+
+bool OpeningBook::lookup(const GameState& state, Action& out) const {
+    if (state.ply >= max_ply || count == 0) return false;
+    const Entry* begin = static_cast<const Entry*>(entries);
+    const Entry* end = begin + count;
+    const uint64_t k = key(state);
+    const Entry* e = lower_bound(begin, end, k, [](const Entry& a, uint64_t b) { return a.key < b; });
+    if (e == end || e->key != k) return false;
+    Action a{static_cast<ActionType>(e->type), e->actor, e->target};
+    if (!state.is_legal(a)) return false;
+    out = a;
+    return true;
+}
+
+}
@@ -0,0 +1,127 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Perft.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+// Direct-mapped cache of subtree counts. Entries are replaced on collision.
+class PerftTable {
+    struct Entry {
+        uint64_t key = 0;
+        PerftResult result;
+    };
+    vector<Entry> entries;
+
+    static uint64_t key_of(uint64_t hash, int depth) {
+        return (hash ^ (static_cast<uint64_t>(depth) * 0x9e3779b97f4a7c15ULL)) | 1;
+    }
+
+public:
+    explicit PerftTable(size_t megabytes) : entries(megabytes * 1024 * 1024 / sizeof(Entry)) {}
+
+    bool enabled() const { return !entries.empty(); }
+
+    const PerftResult* find(uint64_t hash, int depth) const {
+        uint64_t key = key_of(hash, depth);
+        const Entry& e = entries[key % entries.size()];
+        return e.key == key ? &e.result : nullptr;
+    }
+
+    void store(uint64_t hash, int depth, const PerftResult& result) {
+        uint64_t key = key_of(hash, depth);
+        entries[key % entries.size()] = {key, result};
+    }
+};
+
+PerftResult count(const GameState& state, int depth, PerftTable& table) {
+    PerftResult result;
+    ActionList legal;
+    state.legal_actions(legal);
+
+    if (depth == 1) {
+        // Bulk count: the leaves need no make
+        for (const Action& a : legal) ++result.by_type[static_cast<int>(a.type)];
+        result.nodes = legal.size();
+        return result;
+    }
+
+    uint64_t hash = 0;
+    if (table.enabled() && depth > 2) {
+        hash = state.hash();
+        if (const PerftResult* hit = table.find(hash, depth)) return *hit;
+    }
+    for (const Action& a : legal) {
+        GameState child = state;
+        child.apply(a);
+        result += count(child, depth - 1, table);
+    }
+    if (table.enabled() && depth > 2) table.store(hash, depth, result);
+    return result;
+}
+
+} // namespace
+
+PerftResult& PerftResult::operator+=(const PerftResult& other) {
+    nodes += other.nodes;
+    for (int i = 0; i < NUM_ACTION_TYPES; ++i) by_type[i] += other.by_type[i];
+    return *this;
+}
+
+vector<pair<Action, PerftResult>> perft_divide(const GameState& state, int depth,
+                                               const PerftOptions& options) {
+    vector<pair<Action, PerftResult>> split;
+    if (depth < 0) throw runtime_error("Perft depth cannot be negative.");
+    if (depth == 0) return split;
+    ActionList legal;
+    state.legal_actions(legal);
+    for (const Action& a : legal) split.push_back({a, {}});
+
+    if (depth == 1) {
+        for (auto& [a, r] : split) {
+            r.nodes = 1;
+            r.by_type[static_cast<int>(a.type)] = 1;
+        }
+        return split;
+    }
+
+    // Root moves are handed out one at a time so uneven subtrees balance out
+    atomic<size_t> next{0};
+    auto worker = [&] {
+        PerftTable table(options.table_mb);
+        for (size_t i = next++; i < split.size(); i = next++) {
+            GameState child = state;
+            child.apply(split[i].first);
+            split[i].second = count(child, depth - 1, table);
+        }
+    };
+    unsigned threads = options.threads ? options.threads : 1;
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    return split;
+}
+
+PerftResult perft(const GameState& state, int depth, const PerftOptions& options) {
+    PerftResult total;
+    if (depth < 0) throw runtime_error("Perft depth cannot be negative.");
+    if (depth == 0) {
+        total.nodes = 1;
+        return total;
+    }
+    if (options.threads <= 1) {
+        PerftTable table(options.table_mb);
+        return count(state, depth, table);
+    }
+    for (const auto& [action, result] : perft_divide(state, depth, options)) total += result;
+    return total;
+}
+
+}
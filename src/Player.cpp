@@ -1,6 +1,7 @@
 // Email: adhamhamoudy3@gmail.com
 #include "Player.hpp"
 #include "Game.hpp"
+#include "GameState.hpp"
 
 using namespace std;
 
@@ -43,6 +44,11 @@ void Player::validate_turn() const {
 }
 
 void Player::end_turn() {
+    record(ActionType::Skip);
+    pass_turn();
+}
+
+void Player::pass_turn() {
     if (used_bribe) {
         used_bribe = false;  // Allow extra move, don't end turn
         return;
@@ -61,6 +67,10 @@ void Player::eliminate() {
     game.eliminate(this);
 }
 
+void Player::record(ActionType type, const Player* target) {
+    game.record(type, this, target);
+}
+
 void Player::add_coins(int amount) {
     coin_count += amount;
 }
@@ -79,7 +89,8 @@ void Player::gather() {
     }
     last_action = "gather";
     add_coins(1);
-    end_turn();
+    record(ActionType::Gather);
+    pass_turn();
 }
 
 void Player::tax() {
@@ -89,7 +100,8 @@ void Player::tax() {
     }
     last_action = "tax";
     add_coins(2);
-    end_turn();
+    record(ActionType::Tax);
+    pass_turn();
 }
 
 void Player::bribe() {
@@ -100,6 +112,7 @@ void Player::bribe() {
     last_action = "bribe";
     remove_coins(4);
     used_bribe = true;
+    record(ActionType::Bribe);
     // No end_turn() to allow another action this turn
 }
 
@@ -118,6 +131,9 @@ void Player::arrest(Player& target) {
     if (target.was_arrested) {
         throw runtime_error("Target already arrested this round.");
     }
+    if (target.role() != "Merchant" && target.coins() < 1) {
+        throw runtime_error("Target has no coins to take.");
+    }
 
     last_action = "arrest";
     target.was_arrested = true;
@@ -131,7 +147,8 @@ void Player::arrest(Player& target) {
 
     this->add_coins(1);
     last_target = target.name();
-    end_turn();
+    record(ActionType::Arrest, &target);
+    pass_turn();
 }
 
 void Player::sanction(Player& target) {
@@ -142,12 +159,16 @@ void Player::sanction(Player& target) {
     if (!target.active()) {
         throw runtime_error("Target is already eliminated.");
     }
+    if (target.role() == "Judge" && coin_count < 4) {
+        throw runtime_error("Not enough coins to sanction a Judge.");
+    }
     last_action = "sanction";
     remove_coins(3);
     target.under_sanction = true;
 
     target.on_sanctioned_by(*this);
-    end_turn();
+    record(ActionType::Sanction, &target);
+    pass_turn();
 }
 
 void Player::set_coup_blocked(bool value) {
@@ -164,8 +185,9 @@ void Player::coup(Player& target) {
     if (!target.active()) {
         throw runtime_error("Target already eliminated.");
     }
-    last_action = "coup";
     game.coup(this, &target);
+    last_action = "coup";  // Only recorded once the coup went through
+    record(ActionType::Coup, &target);
 }
 
 bool Player::is_coup_blocked() const {
@@ -0,0 +1,30 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Policy.hpp"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+void UniformPolicy::distribution(const GameState& /*state*/, const ActionList& legal, float* probs) const {
+    for (int i = 0; i < legal.size(); ++i) probs[i] = 1.0f / static_cast<float>(legal.size());
+}
+
+Action PolicyBot::choose(const GameState& state) {
+    ActionList legal;
+    state.legal_actions(legal);
+    if (legal.empty()) {
+        throw runtime_error("No legal actions: the game is over.");
+    }
+    float probs[MAX_ACTIONS];
+    policy.distribution(state, legal, probs);
+    float r = static_cast<float>(rng.next() >> 40) / static_cast<float>(1 << 24);
+    for (int i = 0; i < legal.size(); ++i) {
+        r -= probs[i];
+        if (r < 0) return legal[i];
+    }
+    return legal[legal.size() - 1];
+}
+
+}
@@ -0,0 +1,400 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Replay.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'O', 'U', 'P', 'R', 'P', 'L', 'Y'};
+const char END_MAGIC[8] = {'C', 'O', 'U', 'P', 'E', 'N', 'D', '\0'};
+const uint32_t END_CODE = NUM_ACTION_TYPES * MAX_PLAYERS * MAX_PLAYERS;
+const int STATE_BYTES = 32;
+const int KEYFRAME_BYTES = 8 + STATE_BYTES;
+const size_t INDEX_SIZE = 8;   // keyframe offset, just before the footer
+
+// Readers take a `get` that returns the next byte or EOF, so the stream
+// reader and the mapped reader share the parsing.
+template <typename Get>
+uint64_t get_varint(Get& get) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = get();
+        if (c == EOF) throw runtime_error("Replay is truncated.");
+        v |= static_cast<uint64_t>(c & 0x7f) << shift;
+        if (!(c & 0x80)) return v;
+    }
+    throw runtime_error("Replay has a malformed number.");
+}
+
+template <typename Get>
+uint64_t get_uint(Get& get, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        int c = get();
+        if (c == EOF) throw runtime_error("Replay is truncated.");
+        v |= static_cast<uint64_t>(c) << (8 * i);
+    }
+    return v;
+}
+
+// Everything up to the first action; returns the format version.
+template <typename Get>
+uint32_t get_header(Get& get, ReplayHeader& head, bool any_rules = false) {
+    for (char m : MAGIC) {
+        if (get() != static_cast<unsigned char>(m)) throw runtime_error("Not a replay.");
+    }
+    const uint64_t version = get_varint(get);
+    if (version < 1 || version > REPLAY_FORMAT_VERSION) throw runtime_error("Replay format version is not supported.");
+    head.rules_version = static_cast<uint32_t>(get_varint(get));
+    if (head.rules_version != RULES_VERSION && !any_rules) throw runtime_error("Replay was recorded under other rules.");
+    head.seed = get_uint(get, 8);
+    const int seats = get();
+    if (seats < 2 || seats > MAX_PLAYERS) throw runtime_error("Replay has a bad seat count.");
+    head.roles.clear();
+    head.names.clear();
+    for (int i = 0; i < seats; ++i) {
+        const int r = get();
+        if (r < 0 || r >= NUM_ROLES) throw runtime_error("Replay has a bad role.");
+        head.roles.push_back(static_cast<Role>(r));
+    }
+    for (int i = 0; i < seats; ++i) {
+        const uint64_t size = get_varint(get);
+        if (size > 4096) throw runtime_error("Replay has a bad name.");
+        string name(size, '\0');
+        for (char& c : name) {
+            int b = get();
+            if (b == EOF) throw runtime_error("Replay is truncated.");
+            c = static_cast<char>(b);
+        }
+        head.names.push_back(name);
+    }
+    return static_cast<uint32_t>(version);
+}
+
+void put_varint(ostream& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.put(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.put(static_cast<char>(v));
+}
+
+void put_uint(ostream& out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.put(static_cast<char>(v >> (8 * i)));
+}
+
+uint32_t encode(const Action& a, int previous, int seats) {
+    const int step = (a.actor - previous + seats) % seats;
+    const int target = needs_target(a.type) ? (a.target - a.actor + seats) % seats : 0;
+    return static_cast<uint32_t>(static_cast<int>(a.type) + NUM_ACTION_TYPES * (target + MAX_PLAYERS * step));
+}
+
+Action decode(uint64_t code, int previous, int seats) {
+    const int type = static_cast<int>(code % NUM_ACTION_TYPES);
+    const int target = static_cast<int>(code / NUM_ACTION_TYPES % MAX_PLAYERS);
+    const int step = static_cast<int>(code / NUM_ACTION_TYPES / MAX_PLAYERS);
+    Action a{static_cast<ActionType>(type), static_cast<uint8_t>((previous + step) % seats), NO_SEAT};
+    if (code >= END_CODE || step >= seats || target >= seats || needs_target(a.type) != (target != 0)) {
+        throw runtime_error("Replay has a malformed action.");
+    }
+    if (target) a.target = static_cast<uint8_t>((a.actor + target) % seats);
+    return a;
+}
+
+void put_state(uint8_t* b, const GameState& s) {
+    b[0] = s.num_seats;
+    b[1] = s.to_move;
+    b[2] = s.alive;
+    b[3] = s.arrested;
+    b[4] = s.sanctioned;
+    b[5] = s.bribed;
+    b[6] = static_cast<uint8_t>(s.ply);
+    b[7] = static_cast<uint8_t>(s.ply >> 8);
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        b[8 + i] = s.coins[i];
+        b[14 + i] = static_cast<uint8_t>(s.roles[i]);
+        b[20 + i] = s.last_target[i];
+        b[26 + i] = s.last_action[i];
+    }
+}
+
+GameState get_state(const uint8_t* b) {
+    GameState s;
+    s.num_seats = b[0];
+    s.to_move = b[1];
+    s.alive = b[2];
+    s.arrested = b[3];
+    s.sanctioned = b[4];
+    s.bribed = b[5];
+    s.ply = static_cast<uint16_t>(b[6] | b[7] << 8);
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        s.coins[i] = b[8 + i];
+        s.roles[i] = static_cast<Role>(b[14 + i] % NUM_ROLES);
+        s.last_target[i] = b[20 + i];
+        s.last_action[i] = b[26 + i];
+    }
+    if (s.num_seats < 2 || s.num_seats > MAX_PLAYERS || s.to_move >= s.num_seats) {
+        throw runtime_error("Replay has a corrupt keyframe.");
+    }
+    return s;
+}
+
+uint64_t read_u64(const uint8_t* b) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(b[i]) << (8 * i);
+    return v;
+}
+
+uint32_t read_u32(const uint8_t* b) {
+    return static_cast<uint32_t>(b[0] | b[1] << 8 | b[2] << 16) | static_cast<uint32_t>(b[3]) << 24;
+}
+
+} // namespace
+
+ReplayWriter::ReplayWriter(ostream& out, const ReplayHeader& header, uint32_t keyframe_interval)
+    : out(out), seats(static_cast<int>(header.roles.size())), previous(seats - 1), interval(keyframe_interval) {
+    if (seats < 2 || seats > MAX_PLAYERS) throw runtime_error("A replay needs 2 to 6 seats.");
+    if (!header.names.empty() && header.names.size() != header.roles.size()) {
+        throw runtime_error("A replay needs one name per seat.");
+    }
+    game = header.start();
+    // Built first to know its size: the keyframe index holds a file offset
+    // and the output need not be seekable
+    ostringstream head;
+    head.write(MAGIC, sizeof(MAGIC));
+    put_varint(head, REPLAY_FORMAT_VERSION);
+    put_varint(head, header.rules_version);
+    put_uint(head, header.seed, 8);
+    head.put(static_cast<char>(seats));
+    for (Role r : header.roles) head.put(static_cast<char>(r));
+    for (int i = 0; i < seats; ++i) {
+        const string name = header.names.empty() ? string() : header.names[i];
+        put_varint(head, name.size());
+        head.write(name.data(), static_cast<streamsize>(name.size()));
+    }
+    const string bytes = head.str();
+    header_bytes = bytes.size();
+    out.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+}
+
+void ReplayWriter::write(const Action& a) {
+    if (finished || a.actor >= seats || (needs_target(a.type) && (a.target >= seats || a.target == a.actor))) {
+        throw runtime_error("Cannot record " + describe(a));
+    }
+    if (interval && count % interval == 0) {
+        uint8_t key[KEYFRAME_BYTES] = {};
+        for (int i = 0; i < 4; ++i) key[i] = static_cast<uint8_t>(stream_bytes >> (8 * i));
+        key[4] = static_cast<uint8_t>(previous);
+        put_state(key + 8, game);
+        keyframes.insert(keyframes.end(), key, key + KEYFRAME_BYTES);
+    }
+    const uint32_t code = encode(a, previous, seats);
+    put_varint(out, code);
+    stream_bytes += code < 0x80 ? 1 : 2;
+    game.apply(a);
+    previous = a.actor;
+    ++count;
+}
+
+void ReplayWriter::finish() {
+    if (finished) return;
+    put_varint(out, END_CODE);
+    const uint64_t index = header_bytes + stream_bytes + 2;  // end code
+    put_uint(out, keyframes.size() / KEYFRAME_BYTES, 4);
+    put_uint(out, interval, 4);
+    out.write(reinterpret_cast<const char*>(keyframes.data()), static_cast<streamsize>(keyframes.size()));
+    put_uint(out, index, 8);
+    put_uint(out, count, 8);
+    put_uint(out, game.hash(), 8);
+    out.write(END_MAGIC, sizeof(END_MAGIC));
+    out.flush();
+    finished = true;
+    if (!out) throw runtime_error("Cannot write the replay.");
+}
+
+ReplayReader::ReplayReader(istream& in) : in(in) {
+    auto get = [&] { return in.get(); };
+    version = get_header(get, head);
+    previous = static_cast<int>(head.roles.size()) - 1;
+}
+
+bool ReplayReader::next(Action& a) {
+    if (done) return false;
+    auto get = [&] { return in.get(); };
+    const uint64_t code = get_varint(get);
+    if (code != END_CODE) {
+        a = decode(code, previous, static_cast<int>(head.roles.size()));
+        previous = a.actor;
+        ++count;
+        return true;
+    }
+    if (version >= 2) {
+        const uint64_t keys = get_uint(get, 4);
+        get_uint(get, 4);  // interval
+        if (!in.ignore(static_cast<streamsize>(keys * KEYFRAME_BYTES))) throw runtime_error("Replay is truncated.");
+        get_uint(get, 8);  // keyframe offset
+    }
+    foot.actions = get_uint(get, 8);
+    foot.final_hash = get_uint(get, 8);
+    for (char m : END_MAGIC) {
+        if (get() != static_cast<unsigned char>(m)) throw runtime_error("Replay footer is corrupt.");
+    }
+    if (foot.actions != count) throw runtime_error("Replay footer is corrupt.");
+    done = true;
+    return false;
+}
+
+const ReplayFooter& ReplayReader::footer() const {
+    if (!done) throw runtime_error("The replay footer follows the last action.");
+    return foot;
+}
+
+void save_replay(const string& path, const ReplayHeader& header, const vector<Action>& actions) {
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) throw runtime_error("Cannot write " + path);
+    ReplayWriter writer(out, header);
+    for (const Action& a : actions) writer.write(a);
+    writer.finish();
+}
+
+bool ReplayCursor::next(Action& a) {
+    if (at >= count) return false;
+    auto get = [&] { return p < end ? static_cast<int>(*p++) : EOF; };
+    a = decode(get_varint(get), previous, game.num_seats);
+    if (!game.is_legal(a)) throw runtime_error("Replay action " + to_string(at) + " is illegal: " + describe(a));
+    game.apply(a);
+    previous = a.actor;
+    ++at;
+    return true;
+}
+
+ReplayFile::ReplayFile(const string& path, bool any_rules) {
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Cannot open " + path);
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        unmap();
+        throw runtime_error("Cannot stat " + path);
+    }
+    map_size = static_cast<size_t>(st.st_size);
+    if (map_size > 0) {
+        map = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) map = nullptr;
+    }
+    if (!map) {
+        unmap();
+        throw runtime_error("Cannot map " + path);
+    }
+    try {
+        const uint8_t* base = static_cast<const uint8_t*>(map);
+        const uint8_t* file_end = base + map_size;
+        const uint8_t* p = base;
+        auto get = [&] { return p < file_end ? static_cast<int>(*p++) : EOF; };
+        const uint32_t version = get_header(get, head, any_rules);
+        stream = p;
+
+        if (map_size < static_cast<size_t>(p - base) + REPLAY_FOOTER_SIZE
+            || memcmp(file_end - sizeof(END_MAGIC), END_MAGIC, sizeof(END_MAGIC)) != 0) {
+            throw runtime_error("Replay footer is corrupt.");
+        }
+        foot.actions = read_u64(file_end - REPLAY_FOOTER_SIZE);
+        foot.final_hash = read_u64(file_end - REPLAY_FOOTER_SIZE + 8);
+        const uint8_t* after_stream = file_end - REPLAY_FOOTER_SIZE;
+        if (version >= 2) {
+            if (after_stream - INDEX_SIZE < stream) throw runtime_error("Replay footer is corrupt.");
+            const uint64_t index = read_u64(after_stream - INDEX_SIZE);
+            if (index < static_cast<uint64_t>(stream - base) + 1 || index + 8 > map_size - REPLAY_FOOTER_SIZE - INDEX_SIZE) {
+                throw runtime_error("Replay keyframe index is corrupt.");
+            }
+            const uint8_t* table = base + index;
+            keyframe_count = read_u32(table);
+            interval = read_u32(table + 4);
+            keys = table + 8;
+            if (static_cast<uint64_t>(keyframe_count) * KEYFRAME_BYTES != static_cast<uint64_t>(after_stream - INDEX_SIZE - keys)
+                || (keyframe_count && !interval)) {
+                throw runtime_error("Replay keyframe index is corrupt.");
+            }
+            after_stream = table;
+        }
+        stream_end = after_stream - 2;  // the end code is two bytes
+        if (stream_end < stream) throw runtime_error("Replay is truncated.");
+    } catch (...) {
+        unmap();
+        throw;
+    }
+}
+
+ReplayFile::~ReplayFile() {
+    unmap();
+}
+
+void ReplayFile::unmap() {
+    if (map) munmap(map, map_size);
+    if (fd >= 0) close(fd);
+    map = nullptr;
+    fd = -1;
+}
+
+ReplayCursor ReplayFile::seek(uint64_t index) const {
+    if (index > foot.actions) throw runtime_error("Replay has only " + to_string(foot.actions) + " actions.");
+    ReplayCursor c;
+    c.p = stream;
+    c.end = stream_end;
+    c.count = foot.actions;
+    c.previous = static_cast<int>(head.roles.size()) - 1;
+    c.game = head.start();
+    if (keyframe_count) {
+        const uint64_t k = min<uint64_t>(index / interval, keyframe_count - 1);
+        const uint8_t* key = keys + k * KEYFRAME_BYTES;
+        const uint32_t offset = read_u32(key);
+        if (offset > static_cast<uint64_t>(stream_end - stream) || key[4] >= head.roles.size()) {
+            throw runtime_error("Replay has a corrupt keyframe.");
+        }
+        c.p = stream + offset;
+        c.previous = key[4];
+        c.game = get_state(key + 8);
+        c.at = k * interval;
+    }
+    Action a;
+    while (c.at < index) c.next(a);
+    return c;
+}
+
+uint64_t ReplayFile::replay_hash() const {
+    ReplayCursor c;  // from the header, not keyframe 0, which is checked too
+    c.p = stream;
+    c.end = stream_end;
+    c.count = foot.actions;
+    c.previous = static_cast<int>(head.roles.size()) - 1;
+    c.game = head.start();
+    uint8_t state[STATE_BYTES];
+    Action a;
+    do {
+        if (interval && c.at % interval == 0 && c.at / interval < keyframe_count) {
+            const uint8_t* key = keys + c.at / interval * KEYFRAME_BYTES;
+            put_state(state, c.game);
+            if (read_u32(key) != static_cast<uint64_t>(c.p - stream) || key[4] != c.previous
+                || memcmp(key + 8, state, STATE_BYTES) != 0) {
+                throw runtime_error("Replay keyframe " + to_string(c.at / interval) + " does not match the game.");
+            }
+        }
+    } while (c.next(a));
+    if (c.p != stream_end) throw runtime_error("Replay has actions past its footer's count.");
+    return c.game.hash();
+}
+
+}
@@ -0,0 +1,75 @@
+// Email: adhamhamoudy3@gmail.com
+#include "ReplayCorpus.hpp"
+#include "Replay.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+CorpusReport verify_corpus(const string& dir, const CorpusConfig& config) {
+    if (!filesystem::is_directory(dir)) throw runtime_error("Not a directory: " + dir);
+
+    atomic<uint64_t> files{0}, actions{0}, mismatches{0}, errors{0};
+    mutex lock;
+    vector<CorpusProblem> problems;
+    auto report = [&](const string& path, const string& what) {
+        lock_guard<mutex> guard(lock);
+        if (problems.size() < config.max_problems) problems.push_back({path, what});
+    };
+    auto check = [&](const vector<string>& paths) {
+        for (const string& path : paths) {
+            try {
+                ReplayFile file(path, config.any_rules);
+                const uint64_t hash = file.replay_hash();
+                actions.fetch_add(file.footer().actions, memory_order_relaxed);
+                if (hash != file.footer().final_hash) {
+                    mismatches.fetch_add(1, memory_order_relaxed);
+                    ostringstream what;
+                    what << hex << "final hash " << hash << ", footer says " << file.footer().final_hash;
+                    report(path, what.str());
+                }
+            } catch (const exception& e) {
+                errors.fetch_add(1, memory_order_relaxed);
+                report(path, e.what());
+            }
+            files.fetch_add(1, memory_order_relaxed);
+        }
+    };
+
+    {
+        WorkStealingPool pool(config.threads);
+        vector<string> batch;
+        const size_t batch_size = max<size_t>(1, config.batch);
+        for (const auto& entry : filesystem::recursive_directory_iterator(dir)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".replay") continue;
+            batch.push_back(entry.path().string());
+            if (batch.size() == batch_size) {
+                pool.submit([&check, paths = move(batch)] { check(paths); });
+                batch.clear();
+            }
+        }
+        if (!batch.empty()) pool.submit([&check, paths = move(batch)] { check(paths); });
+        pool.wait();
+    }
+
+    CorpusReport result;
+    result.files = files;
+    result.actions = actions;
+    result.mismatches = mismatches;
+    result.errors = errors;
+    result.problems = move(problems);
+    sort(result.problems.begin(), result.problems.end(),
+         [](const CorpusProblem& a, const CorpusProblem& b) { return a.path < b.path; });
+    return result;
+}
+
+}
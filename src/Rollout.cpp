@@ -0,0 +1,65 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Rollout.hpp"
+#include "HeuristicBot.hpp"
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+HeuristicParams with_noise(HeuristicParams params) {
+    params.epsilon = 0.1f;
+    return params;
+}
+
+const HeuristicParams GREEDY = with_noise(HeuristicParams::greedy());
+const HeuristicParams ECONOMIC = with_noise(HeuristicParams::economic());
+const HeuristicParams AGGRESSIVE = with_noise(HeuristicParams::aggressive());
+
+} // namespace
+
+Rewards final_rewards(const GameState& state) {
+    Rewards r{};
+    int alive = state.alive_count();
+    for (int i = 0; i < state.num_seats; ++i) {
+        if (state.is_alive(i)) r[i] = 1.0f / alive;
+    }
+    return r;
+}
+
+Action rollout_action(const GameState& state, RolloutPolicy policy, FastRng& rng) {
+    switch (policy) {
+        case RolloutPolicy::Greedy: return heuristic_action(state, GREEDY, rng);
+        case RolloutPolicy::Economic: return heuristic_action(state, ECONOMIC, rng);
+        case RolloutPolicy::Aggressive: return heuristic_action(state, AGGRESSIVE, rng);
+        default: break;
+    }
+    ActionList legal;
+    state.legal_actions(legal);
+    if (policy == RolloutPolicy::Heuristic) {
+        // Coup the richest opponent when possible, otherwise grow the purse
+        const Action* best = nullptr;
+        for (const Action& a : legal) {
+            if (a.type == ActionType::Coup && (!best || state.coins[a.target] > state.coins[best->target])) {
+                best = &a;
+            }
+        }
+        if (best) return *best;
+        if (rng.below(4) != 0) {
+            for (const Action& a : legal) {
+                if (a.type == ActionType::Invest || a.type == ActionType::Tax) return a;
+            }
+        }
+    }
+    return legal[static_cast<int>(rng.below(static_cast<uint32_t>(legal.size())))];
+}
+
+Rewards rollout(GameState state, RolloutPolicy policy, int max_plies, FastRng& rng) {
+    for (int ply = 0; ply < max_plies && !state.is_terminal(); ++ply) {
+        state.apply(rollout_action(state, policy, rng));
+    }
+    return final_rewards(state);
+}
+
+}
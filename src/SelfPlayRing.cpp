@@ -0,0 +1,199 @@
+// Email: adhamhamoudy3@gmail.com
+#include "SelfPlayRing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'O', 'U', 'P', 'R', 'I', 'N', 'G'};
+const uint32_t FORMAT_VERSION = 1;
+
+// Shared between processes, so the atomics must not hide a lock
+static_assert(atomic<uint64_t>::is_always_lock_free);
+static_assert(atomic<uint32_t>::is_always_lock_free);
+
+struct alignas(64) Slot {
+    atomic<uint64_t> seq;
+    SelfPlayRecord record;
+};
+
+} // namespace
+
+struct SelfPlayRing::Shared {
+    char magic[8];               // written last, once the rest is ready
+    uint32_t format_version;
+    uint32_t rules_version;
+    uint32_t capacity;
+    uint32_t record_size;
+    alignas(64) atomic<uint64_t> head;   // next slot to claim
+    alignas(64) atomic<uint64_t> tail;   // next slot to read
+    alignas(64) atomic<uint64_t> pushed;
+    atomic<uint64_t> stalls;
+    atomic<uint32_t> closed;
+
+    Slot* slots() { return reinterpret_cast<Slot*>(this + 1); }
+};
+
+SelfPlayRing::SelfPlayRing(const string& name, uint32_t capacity) : name(name), owner(true) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        throw runtime_error("Ring capacity must be a power of two.");
+    }
+    shm_unlink(name.c_str());  // a learner that crashed leaves its ring behind
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw runtime_error("Cannot create shared memory " + name);
+    map_size = sizeof(Shared) + static_cast<size_t>(capacity) * sizeof(Slot);
+    if (ftruncate(fd, static_cast<off_t>(map_size)) != 0) {
+        unmap();
+        throw runtime_error("Cannot size shared memory " + name);
+    }
+    map = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        map = nullptr;
+        unmap();
+        throw runtime_error("Cannot map shared memory " + name);
+    }
+    shared = new (map) Shared();
+    shared->format_version = FORMAT_VERSION;
+    shared->rules_version = RULES_VERSION;
+    shared->capacity = capacity;
+    shared->record_size = sizeof(SelfPlayRecord);
+    for (uint32_t i = 0; i < capacity; ++i) {
+        Slot* slot = new (&shared->slots()[i]) Slot();
+        slot->seq.store(i, memory_order_relaxed);
+    }
+    atomic_thread_fence(memory_order_release);
+    memcpy(shared->magic, MAGIC, sizeof(MAGIC));
+}
+
+SelfPlayRing::SelfPlayRing(const string& name) : name(name) {
+    fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) throw runtime_error("No ring named " + name);
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Shared)) {
+        unmap();
+        throw runtime_error(name + " is not a self-play ring.");
+    }
+    map_size = static_cast<size_t>(st.st_size);
+    map = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        map = nullptr;
+        unmap();
+        throw runtime_error("Cannot map shared memory " + name);
+    }
+    shared = static_cast<Shared*>(map);
+    atomic_thread_fence(memory_order_acquire);
+    if (memcmp(shared->magic, MAGIC, sizeof(MAGIC)) != 0 || shared->format_version != FORMAT_VERSION
+        || shared->rules_version != RULES_VERSION || shared->record_size != sizeof(SelfPlayRecord)
+        || map_size != sizeof(Shared) + static_cast<size_t>(shared->capacity) * sizeof(Slot)) {
+        unmap();
+        throw runtime_error(name + " is not a ring for this build.");
+    }
+}
+
+SelfPlayRing::~SelfPlayRing() {
+    unmap();
+    if (owner) shm_unlink(name.c_str());
+}
+
+void SelfPlayRing::unmap() {
+    if (map) munmap(map, map_size);
+    if (fd >= 0) ::close(fd);
+    map = nullptr;
+    shared = nullptr;
+    fd = -1;
+}
+
+uint32_t SelfPlayRing::capacity() const {
+    return shared->capacity;
+}
+
+size_t SelfPlayRing::size() const {
+    const uint64_t tail = shared->tail.load(memory_order_acquire);
+    const uint64_t head = shared->head.load(memory_order_acquire);
+    return head > tail ? static_cast<size_t>(head - tail) : 0;
+}
+
+bool SelfPlayRing::try_push(const SelfPlayRecord& record) {
+    if (shared->closed.load(memory_order_acquire)) return false;
+    const uint64_t mask = shared->capacity - 1;
+    uint64_t pos = shared->head.load(memory_order_relaxed);
+    while (true) {
+        Slot& slot = shared->slots()[pos & mask];
+        const uint64_t seq = slot.seq.load(memory_order_acquire);
+        const int64_t diff = static_cast<int64_t>(seq - pos);
+        if (diff == 0) {
+            if (shared->head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                slot.record = record;
+                slot.seq.store(pos + 1, memory_order_release);
+                shared->pushed.fetch_add(1, memory_order_relaxed);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // the learner has not freed this slot yet
+        } else {
+            pos = shared->head.load(memory_order_relaxed);
+        }
+    }
+}
+
+bool SelfPlayRing::push(const SelfPlayRecord& record) {
+    if (try_push(record)) return true;
+    shared->stalls.fetch_add(1, memory_order_relaxed);
+    for (int wait = 0;; ++wait) {
+        if (shared->closed.load(memory_order_acquire)) return false;
+        if (wait < 16) {
+            this_thread::yield();
+        } else {
+            this_thread::sleep_for(chrono::microseconds(min(1000, 10 << min(wait - 16, 7))));
+        }
+        if (try_push(record)) return true;
+    }
+}
+
+size_t SelfPlayRing::pop_batch(SelfPlayRecord* out, size_t max) {
+    const uint64_t mask = shared->capacity - 1;
+    uint64_t pos = shared->tail.load(memory_order_relaxed);
+    size_t n = 0;
+    while (n < max) {
+        Slot& slot = shared->slots()[pos & mask];
+        if (slot.seq.load(memory_order_acquire) != pos + 1) break;  // not published yet
+        out[n++] = slot.record;
+        slot.seq.store(pos + shared->capacity, memory_order_release);
+        ++pos;
+    }
+    shared->tail.store(pos, memory_order_release);
+    return n;
+}
+
+void SelfPlayRing::close() {
+    shared->closed.store(1, memory_order_release);
+}
+
+bool SelfPlayRing::closed() const {
+    return shared->closed.load(memory_order_acquire) != 0;
+}
+
+uint64_t SelfPlayRing::pushed() const {
+    return shared->pushed.load(memory_order_relaxed);
+}
+
+uint64_t SelfPlayRing::stalls() const {
+    return shared->stalls.load(memory_order_relaxed);
+}
+
+}
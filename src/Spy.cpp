@@ -1,5 +1,6 @@
 // Email: adhamhamoudy3@gmail.com
 #include "Spy.hpp"
+#include "GameState.hpp"
 #include <iostream>
 
 using namespace std;
@@ -24,6 +25,7 @@ void Spy::spy_on(Player& target) {
 
     // Prevent target from arresting in their next turn
     target.block_arrest();
+    record(ActionType::SpyOn, &target);
 }
 
 }
@@ -0,0 +1,318 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Tablebase.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'O', 'U', 'P', 'T', 'B', 0, 0};
+const uint32_t FORMAT_VERSION = 1;
+const uint8_t LOSS = 0x80;
+const uint64_t FLAG_STATES = 2 * 4 * 4 * 4 * 4 * 4;  // to move, five seat-pair flags
+
+struct Header {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t rules_version;
+    uint32_t coin_cap;
+    uint32_t passes_done;  // checkpoint: passes fully written
+    uint32_t complete;
+    uint32_t reserved;
+    uint64_t role_pairs;
+    uint64_t entries;
+    uint64_t solved;
+    uint8_t padding[8];
+};
+static_assert(sizeof(Header) == 64, "tablebase header must stay 64 bytes");
+
+// Position <-> index. Seats are the two alive seats, lower one first.
+struct Layout {
+    uint64_t role_pairs;
+    uint64_t cap;
+
+    uint64_t entries() const {
+        return static_cast<uint64_t>(popcount(role_pairs)) * cap * cap * FLAG_STATES;
+    }
+
+    bool index_of(const GameState& s, uint64_t& idx) const {
+        if (s.alive_count() != 2) return false;
+        int a = countr_zero(static_cast<unsigned>(s.alive));
+        int b = countr_zero(static_cast<unsigned>(s.alive & ~(1u << a)));
+        int pair = static_cast<int>(s.roles[a]) * NUM_ROLES + static_cast<int>(s.roles[b]);
+        if (!((role_pairs >> pair) & 1) || s.coins[a] >= cap || s.coins[b] >= cap) return false;
+
+        auto bits = [&](uint8_t mask) { return ((mask >> a) & 1) | ((mask >> b) & 1) << 1; };
+        const uint8_t tax = static_cast<uint8_t>(ActionType::Tax);
+        idx = static_cast<uint64_t>(popcount(role_pairs & ((1ULL << pair) - 1)));
+        idx = idx * cap + s.coins[a];
+        idx = idx * cap + s.coins[b];
+        idx = idx * 2 + (s.to_move == b);
+        idx = idx * 4 + bits(s.arrested);
+        idx = idx * 4 + bits(s.sanctioned);
+        idx = idx * 4 + bits(s.bribed);
+        idx = idx * 4 + ((s.last_target[a] == b) | (s.last_target[b] == a) << 1);
+        idx = idx * 4 + ((s.last_action[a] == tax) | (s.last_action[b] == tax) << 1);
+        return true;
+    }
+
+    GameState decode(uint64_t idx) const {
+        GameState s;
+        s.num_seats = 2;
+        s.alive = 3;
+        s.last_target.fill(NO_SEAT);
+        s.last_action.fill(NO_ACTION);
+        uint64_t last_tax = idx % 4; idx /= 4;
+        uint64_t last_target = idx % 4; idx /= 4;
+        s.bribed = static_cast<uint8_t>(idx % 4); idx /= 4;
+        s.sanctioned = static_cast<uint8_t>(idx % 4); idx /= 4;
+        s.arrested = static_cast<uint8_t>(idx % 4); idx /= 4;
+        s.to_move = static_cast<uint8_t>(idx % 2); idx /= 2;
+        s.coins[1] = static_cast<uint8_t>(idx % cap); idx /= cap;
+        s.coins[0] = static_cast<uint8_t>(idx % cap); idx /= cap;
+        for (int t = 0; t < 2; ++t) {
+            if ((last_tax >> t) & 1) s.last_action[t] = static_cast<uint8_t>(ActionType::Tax);
+            if ((last_target >> t) & 1) s.last_target[t] = static_cast<uint8_t>(1 - t);
+        }
+        // idx is now the rank of the role pair among the included ones
+        uint64_t pairs = role_pairs;
+        for (uint64_t skip = idx; skip > 0; --skip) pairs &= pairs - 1;
+        int pair = countr_zero(pairs);
+        s.roles[0] = static_cast<Role>(pair / NUM_ROLES);
+        s.roles[1] = static_cast<Role>(pair % NUM_ROLES);
+        return s;
+    }
+};
+
+const int UNKNOWN = -1;
+
+// What reaching child means for the player who moved: UNKNOWN, or a table
+// byte (win or loss, and the pass that solved it) from the mover's side.
+// A coup that ends the game is a win solved at pass 0.
+int value_for_mover(const Layout& layout, const uint8_t* values, const GameState& before,
+                    const GameState& child) {
+    if (child.is_terminal()) return child.winner() == before.to_move ? 0 : LOSS;
+    uint64_t idx;
+    if (!layout.index_of(child, idx) || values[idx] == 0) return UNKNOWN;
+    uint8_t v = values[idx];
+    return child.to_move == before.to_move ? v : v ^ LOSS;
+}
+
+bool is_win(int v) { return v < LOSS; }
+int pass_of(int v) { return v & ~LOSS; }
+
+class Mapping {
+public:
+    int fd = -1;
+    void* map = MAP_FAILED;
+    size_t size = 0;
+
+    ~Mapping() {
+        if (map != MAP_FAILED) munmap(map, size);
+        if (fd >= 0) close(fd);
+    }
+};
+
+} // namespace
+
+uint64_t build_tablebase(const string& path, const TablebaseConfig& config, ostream* progress) {
+    if (config.coin_cap < 1 || config.coin_cap > 16) throw runtime_error("coin_cap must be 1..16.");
+    if (config.max_passes < 1 || config.max_passes > 127) throw runtime_error("max_passes must be 1..127.");
+    const Layout layout{config.role_pairs & ALL_ROLE_PAIRS, static_cast<uint64_t>(config.coin_cap)};
+    const uint64_t entries = layout.entries();
+    if (entries == 0) throw runtime_error("No role pairs selected.");
+
+    Mapping m;
+    m.fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m.fd < 0) throw runtime_error("Cannot open " + path);
+    struct stat st{};
+    if (fstat(m.fd, &st) != 0) throw runtime_error("Cannot stat " + path);
+    const bool resume = st.st_size > 0;
+    m.size = sizeof(Header) + entries;
+    if (resume && static_cast<size_t>(st.st_size) != m.size) {
+        throw runtime_error(path + " holds a table of another size.");
+    }
+    if (!resume && ftruncate(m.fd, static_cast<off_t>(m.size)) != 0) {
+        throw runtime_error("Cannot resize " + path);
+    }
+    m.map = mmap(nullptr, m.size, PROT_READ | PROT_WRITE, MAP_SHARED, m.fd, 0);
+    if (m.map == MAP_FAILED) throw runtime_error("Cannot map " + path);
+
+    Header* header = static_cast<Header*>(m.map);
+    uint8_t* values = static_cast<uint8_t*>(m.map) + sizeof(Header);
+    if (resume) {
+        if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->format_version != FORMAT_VERSION
+            || header->rules_version != RULES_VERSION || header->coin_cap != layout.cap
+            || header->role_pairs != layout.role_pairs) {
+            throw runtime_error(path + " was built for another configuration or rules version.");
+        }
+        if (header->complete) return header->solved;
+        // A build stopped in the middle of a pass leaves some of that pass's
+        // results behind; later positions of the pass would read them as
+        // earlier ones. Drop them and recount, so the pass is redone whole.
+        uint64_t solved = 0;
+        for (uint64_t idx = 0; idx < entries; ++idx) {
+            if (pass_of(values[idx]) > static_cast<int>(header->passes_done)) values[idx] = 0;
+            solved += values[idx] != 0;
+        }
+        header->solved = solved;
+    } else {
+        memcpy(header->magic, MAGIC, sizeof(MAGIC));
+        header->format_version = FORMAT_VERSION;
+        header->rules_version = RULES_VERSION;
+        header->coin_cap = static_cast<uint32_t>(layout.cap);
+        header->role_pairs = layout.role_pairs;
+        header->entries = entries;
+    }
+
+    const unsigned threads = config.threads ? config.threads : 1;
+    const uint64_t CHUNK = 1 << 16;
+    for (int pass = static_cast<int>(header->passes_done) + 1; pass <= config.max_passes; ++pass) {
+        // Every thread reads only results of earlier passes, so the pass
+        // number is exact and the workers never race on the table
+        atomic<uint64_t> next{0};
+        vector<vector<pair<uint64_t, uint8_t>>> found(threads);
+        auto work = [&](unsigned t) {
+            ActionList legal;
+            for (uint64_t begin; (begin = next.fetch_add(CHUNK)) < entries;) {
+                uint64_t end = begin + CHUNK < entries ? begin + CHUNK : entries;
+                for (uint64_t idx = begin; idx < end; ++idx) {
+                    if (values[idx]) continue;
+                    GameState s = layout.decode(idx);
+                    s.legal_actions(legal);
+                    bool win = false;
+                    bool all_lost = true;
+                    for (const Action& a : legal) {
+                        GameState child = s;
+                        child.apply(a);
+                        int v = value_for_mover(layout, values, s, child);
+                        if (v == UNKNOWN) {
+                            all_lost = false;
+                        } else if (is_win(v)) {
+                            win = true;
+                            break;
+                        }
+                    }
+                    if (win) {
+                        found[t].push_back({idx, static_cast<uint8_t>(pass)});
+                    } else if (all_lost) {
+                        found[t].push_back({idx, static_cast<uint8_t>(LOSS | pass)});
+                    }
+                }
+            }
+        };
+        vector<thread> pool;
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work, t);
+        work(0);
+        for (auto& t : pool) t.join();
+
+        uint64_t solved = 0;
+        for (const auto& list : found) {
+            for (const auto& [idx, v] : list) values[idx] = v;
+            solved += list.size();
+        }
+        // The pass's results reach the disk before the header counts them
+        msync(m.map, m.size, MS_SYNC);
+        header->solved += solved;
+        header->passes_done = static_cast<uint32_t>(pass);
+        if (solved == 0) header->complete = 1;
+        msync(m.map, sizeof(Header), MS_SYNC);
+        if (progress) *progress << "pass " << pass << ": " << solved << " solved" << endl;
+        if (solved == 0) break;
+    }
+    return header->solved;
+}
+
+Tablebase::Tablebase(const string& path) {
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Cannot open " + path);
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        unmap();
+        throw runtime_error("Cannot stat " + path);
+    }
+    map_size = static_cast<size_t>(st.st_size);
+    if (map_size >= sizeof(Header)) {
+        map = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) map = nullptr;
+    }
+    const Header* header = static_cast<const Header*>(map);
+    if (!header || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+        || header->format_version != FORMAT_VERSION || map_size != sizeof(Header) + header->entries) {
+        unmap();
+        throw runtime_error(path + " is not a tablebase.");
+    }
+    if (header->rules_version != RULES_VERSION || !header->complete) {
+        unmap();
+        throw runtime_error(path + " is unfinished or was built for other rules.");
+    }
+    values = static_cast<const uint8_t*>(map) + sizeof(Header);
+    role_pairs = header->role_pairs;
+    cap = static_cast<int>(header->coin_cap);
+}
+
+Tablebase::~Tablebase() {
+    unmap();
+}
+
+void Tablebase::unmap() {
+    if (map) munmap(map, map_size);
+    if (fd >= 0) close(fd);
+    map = nullptr;
+    fd = -1;
+}
+
+int Tablebase::coin_cap() const {
+    return cap;
+}
+
+uint64_t Tablebase::size() const {
+    return map_size - sizeof(Header);
+}
+
+TablebaseProbe Tablebase::probe(const GameState& state) const {
+    TablebaseProbe result;
+    uint64_t idx;
+    if (!Layout{role_pairs, static_cast<uint64_t>(cap)}.index_of(state, idx) || values[idx] == 0) return result;
+    result.outcome = is_win(values[idx]) ? Outcome::Win : Outcome::Loss;
+    result.distance = pass_of(values[idx]);
+    return result;
+}
+
+bool Tablebase::best_action(const GameState& state, Action& out) const {
+    TablebaseProbe here = probe(state);
+    if (here.outcome != Outcome::Win) return false;
+    const Layout layout{role_pairs, static_cast<uint64_t>(cap)};
+    ActionList legal;
+    state.legal_actions(legal);
+    int best_pass = here.distance;
+    bool found = false;
+    for (const Action& a : legal) {
+        GameState child = state;
+        child.apply(a);
+        int v = value_for_mover(layout, values, state, child);
+        if (v != UNKNOWN && is_win(v) && pass_of(v) < best_pass) {
+            best_pass = pass_of(v);
+            out = a;
+            found = true;
+        }
+    }
+    return found;
+}
+
+}
@@ -0,0 +1,240 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Tournament.hpp"
+#include "Replay.hpp"
+#include "Rollout.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+struct GameOutcome {
+    vector<int> rank;  // per seat, 0 = best; equal ranks tie
+    bool draw = false;
+};
+
+// Plays one game; seats are ranked by when they were eliminated.
+GameOutcome play_ranked(const GameState& start, const vector<unique_ptr<Bot>>& bots,
+                        const vector<string>& names, int max_plies, vector<Action>* moves) {
+    GameState s = start;
+    for (int seat = 0; seat < s.num_seats; ++seat) bots[seat]->on_game_start(s, seat);
+    GameOutcome out;
+    out.rank.assign(s.num_seats, 0);
+    int next_rank = s.num_seats - 1;
+    for (int ply = 0; ply < max_plies && !s.is_terminal(); ++ply) {
+        const uint8_t before = s.alive;
+        const int mover = s.to_move;
+        Action a = bots[mover]->choose(s);
+        if (!s.is_legal(a)) throw runtime_error(names[mover] + " played an illegal move: " + describe(a));
+        s.apply(a);
+        if (moves) moves->push_back(a);
+        for (const auto& bot : bots) bot->on_action(a, s);
+        const uint8_t eliminated = before & ~s.alive;
+        if (!eliminated) continue;
+        for (int seat = 0; seat < s.num_seats; ++seat) {
+            if ((eliminated >> seat) & 1) out.rank[seat] = next_rank;
+        }
+        next_rank -= popcount(static_cast<unsigned>(eliminated));
+    }
+    out.draw = !s.is_terminal();
+    return out;
+}
+
+uint64_t choose_count(uint64_t n, uint64_t k) {
+    uint64_t c = 1;
+    for (uint64_t i = 1; i <= k; ++i) c = c * (n - k + i) / i;
+    return c;
+}
+
+} // namespace
+
+Tournament::Tournament(vector<Entrant> entrants, const TournamentConfig& config)
+    : entrants(move(entrants)), config(config), stats(this->entrants.size()) {
+    if (config.seats < 2 || config.seats > MAX_PLAYERS) {
+        throw runtime_error("A tournament game needs 2-6 seats.");
+    }
+    if (static_cast<int>(this->entrants.size()) < config.seats) {
+        throw runtime_error("Not enough entrants for a full table.");
+    }
+    if (config.deals < 1) {
+        throw runtime_error("A meeting needs at least one deal.");
+    }
+}
+
+void Tournament::run(ostream* out) {
+    const int n = static_cast<int>(entrants.size());
+    const int k = config.seats;
+    progress = out;
+    WorkStealingPool pool(config.threads);
+    uint64_t meeting = 0;
+    auto submit = [&](const vector<int>& group) {
+        const uint64_t id = meeting++;
+        pool.submit([this, &pool, group, id] {
+            // Deals go to this worker's deque, where idle workers steal them
+            for (int deal = 0; deal < config.deals; ++deal) {
+                pool.submit([this, group, id, deal] { play_deal(group, id * config.deals + deal); });
+            }
+        });
+    };
+    const uint64_t per_meeting = static_cast<uint64_t>(config.deals) * k;
+    // Deal ids (meeting * deals + deal) seed the games and name the replays
+    const uint64_t meetings = config.schedule == Schedule::RoundRobin
+        ? choose_count(n, k)
+        : static_cast<uint64_t>(max(config.rounds, 0)) * ((n + k - 1) / k);
+    if (meetings > UINT64_MAX / static_cast<uint64_t>(config.deals)) {
+        throw runtime_error("Too many deals to number.");
+    }
+
+    if (config.schedule == Schedule::RoundRobin) {
+        if (progress) *progress << choose_count(n, k) * per_meeting << " games scheduled" << endl;
+        vector<int> group(k);
+        for (int i = 0; i < k; ++i) group[i] = i;
+        while (true) {
+            submit(group);
+            // Next combination in lexicographic order
+            int i = k - 1;
+            while (i >= 0 && group[i] == n - k + i) --i;
+            if (i < 0) break;
+            ++group[i];
+            for (int j = i + 1; j < k; ++j) group[j] = group[j - 1] + 1;
+        }
+        pool.wait();
+        return;
+    }
+
+    const int groups = (n + k - 1) / k;
+    if (progress) *progress << static_cast<uint64_t>(config.rounds) * groups * per_meeting << " games scheduled" << endl;
+    FastRng rng(config.seed);
+    for (int round = 0; round < config.rounds; ++round) {
+        vector<int> order(n);
+        for (int i = 0; i < n; ++i) order[i] = i;
+        if (round == 0) {
+            for (int i = n - 1; i > 0; --i) swap(order[i], order[rng.below(i + 1)]);
+        } else {
+            lock_guard<mutex> guard(lock);
+            stable_sort(order.begin(), order.end(), [&](int a, int b) { return stats[a].elo > stats[b].elo; });
+        }
+        for (int g = 0; g < groups; ++g) {
+            // The last group is filled from the bottom of the standings
+            int first = min(g * k, n - k);
+            submit(vector<int>(order.begin() + first, order.begin() + first + k));
+        }
+        pool.wait();
+    }
+}
+
+void Tournament::play_deal(const vector<int>& group, uint64_t deal_id) {
+    const int k = static_cast<int>(group.size());
+    const uint64_t deal_seed = config.seed * 0x9e3779b97f4a7c15ULL + deal_id;
+    FastRng rng(deal_seed);
+    vector<Role> roles(k);
+    for (Role& r : roles) r = static_cast<Role>(rng.below(NUM_ROLES));
+    const GameState start = GameState::initial(roles);
+
+    for (int rotation = 0; rotation < k; ++rotation) {
+        vector<int> seat_entrant(k);
+        vector<unique_ptr<Bot>> bots;
+        vector<string> names;
+        for (int seat = 0; seat < k; ++seat) {
+            seat_entrant[seat] = group[(seat + rotation) % k];
+            const Entrant& e = entrants[seat_entrant[seat]];
+            bots.push_back(e.make(rng.next() | 1));
+            names.push_back(e.name);
+        }
+        vector<Action> moves;
+        const bool save = !config.replay_dir.empty();
+        GameOutcome outcome = play_ranked(start, bots, names, config.max_plies, save ? &moves : nullptr);
+        if (save) {
+            ReplayHeader header;
+            header.seed = deal_seed;
+            header.roles = roles;
+            header.names = names;
+            save_replay(config.replay_dir + "/" + to_string(deal_id) + "_" + to_string(rotation) + ".replay",
+                        header, moves);
+        }
+        record(seat_entrant, outcome.rank, outcome.draw);
+    }
+}
+
+void Tournament::record(const vector<int>& seat_entrant, const vector<int>& rank, bool draw) {
+    const int k = static_cast<int>(seat_entrant.size());
+    lock_guard<mutex> guard(lock);
+    vector<double> delta(k, 0.0);
+    const double step = config.k_factor / (k - 1);
+    for (int i = 0; i < k; ++i) {
+        for (int j = i + 1; j < k; ++j) {
+            Stats& a = stats[seat_entrant[i]];
+            Stats& b = stats[seat_entrant[j]];
+            double s = rank[i] < rank[j] ? 1.0 : rank[i] == rank[j] ? 0.5 : 0.0;
+            double expected = 1.0 / (1.0 + pow(10.0, (b.elo - a.elo) / 400.0));
+            delta[i] += step * (s - expected);
+            delta[j] -= step * (s - expected);
+            a.score += s;
+            b.score += 1.0 - s;
+            ++a.pairings;
+            ++b.pairings;
+        }
+    }
+    for (int i = 0; i < k; ++i) {
+        Stats& st = stats[seat_entrant[i]];
+        st.elo += delta[i];
+        ++st.games;
+        if (rank[i] == 0) ++(draw ? st.draws : st.wins);
+    }
+    ++played;
+    if (progress && played % 10000 == 0) *progress << played << " games played" << endl;
+}
+
+uint64_t Tournament::games_played() const {
+    lock_guard<mutex> guard(lock);
+    return played;
+}
+
+vector<Rating> Tournament::table() const {
+    lock_guard<mutex> guard(lock);
+    vector<Rating> table;
+    for (size_t i = 0; i < entrants.size(); ++i) {
+        const Stats& st = stats[i];
+        Rating r;
+        r.name = entrants[i].name;
+        r.elo = st.elo;
+        r.games = st.games;
+        r.wins = st.wins;
+        r.draws = st.draws;
+        if (st.pairings > 0) {
+            // Delta method on the logistic curve: 1.96 standard errors of
+            // the pairwise score, in Elo
+            double p = clamp(st.score / static_cast<double>(st.pairings), 0.02, 0.98);
+            r.margin = 1.96 * 400.0 / log(10.0) / sqrt(static_cast<double>(st.pairings) * p * (1 - p));
+        }
+        table.push_back(r);
+    }
+    stable_sort(table.begin(), table.end(), [](const Rating& a, const Rating& b) { return a.elo > b.elo; });
+    return table;
+}
+
+void print_ratings(ostream& out, const vector<Rating>& table) {
+    const ios::fmtflags flags = out.flags();
+    const streamsize precision = out.precision();
+    out << "rank  name            elo     +-    games   win%  draw%" << endl;
+    for (size_t i = 0; i < table.size(); ++i) {
+        const Rating& r = table[i];
+        double games = r.games ? static_cast<double>(r.games) : 1.0;
+        out << left << setw(6) << i + 1 << setw(14) << r.name << right << fixed << setprecision(0)
+            << setw(6) << r.elo << setw(7) << r.margin << setw(9) << r.games << setprecision(1)
+            << setw(7) << 100.0 * r.wins / games << setw(7) << 100.0 * r.draws / games << endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+}
@@ -0,0 +1,210 @@
+// Email: adhamhamoudy3@gmail.com
+#include "Tuner.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+const int FORMAT_VERSION = 1;
+const int MAX_PLIES = 400;
+const uint64_t GOLDEN = 0x9e3779b97f4a7c15ULL;
+
+float gaussian(FastRng& rng) {
+    // Box-Muller; u1 is kept away from 0
+    double u1 = (static_cast<double>(rng.next() >> 11) + 1.0) / 9007199254740993.0;
+    double u2 = static_cast<double>(rng.next() >> 11) / 9007199254740992.0;
+    return static_cast<float>(sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2));
+}
+
+Genes mutate(Genes g, const TunerConfig& config, FastRng& rng) {
+    for (float& x : g) {
+        if (static_cast<float>(rng.next() >> 40) < config.mutation_rate * static_cast<float>(1 << 24)) {
+            x += config.mutation_scale * (0.5f + 0.5f * fabs(x)) * gaussian(rng);
+        }
+    }
+    return g;
+}
+
+} // namespace
+
+Genes to_genes(const HeuristicParams& params) {
+    Genes g{};
+    for (int i = 0; i < NUM_ACTION_TYPES; ++i) g[i] = params.action_weight[i];
+    g[NUM_ACTION_TYPES] = params.per_target_coin;
+    g[NUM_ACTION_TYPES + 1] = params.threat_bonus;
+    g[NUM_ACTION_TYPES + 2] = params.per_coin_spent;
+    return g;
+}
+
+HeuristicParams from_genes(const Genes& g) {
+    HeuristicParams params;
+    for (int i = 0; i < NUM_ACTION_TYPES; ++i) params.action_weight[i] = g[i];
+    params.per_target_coin = g[NUM_ACTION_TYPES];
+    params.threat_bonus = g[NUM_ACTION_TYPES + 1];
+    params.per_coin_spent = g[NUM_ACTION_TYPES + 2];
+    return params;
+}
+
+Tuner::Tuner(const TunerConfig& config) : config(config) {
+    if (config.population < 2 || config.elite >= config.population || config.opponents.empty()
+        || config.seats < 2 || config.seats > MAX_PLAYERS || config.games < 1 || config.batch < 1) {
+        throw runtime_error("Invalid tuner configuration.");
+    }
+    if (load()) return;
+
+    // Start from the opponents themselves plus mutated copies of them
+    FastRng rng(config.seed);
+    for (int i = 0; i < config.population; ++i) {
+        Candidate c;
+        c.genes = to_genes(config.opponents[i % config.opponents.size()]);
+        if (i >= static_cast<int>(config.opponents.size())) c.genes = mutate(c.genes, config, rng);
+        pop.push_back(c);
+    }
+}
+
+double Tuner::play(const HeuristicParams& params, int g, int game) const {
+    // Everything random in a game comes from its own seed, the same for
+    // every candidate (common random numbers)
+    const int seats = config.seats;
+    FastRng rng(config.seed * GOLDEN + static_cast<uint64_t>(g) * 1000003 + static_cast<uint64_t>(game));
+    vector<Role> roles(seats);
+    for (Role& r : roles) r = static_cast<Role>(rng.below(NUM_ROLES));
+    const int me = game % seats;
+    HeuristicParams players[MAX_PLAYERS];
+    for (int seat = 0; seat < seats; ++seat) {
+        players[seat] = config.opponents[rng.below(static_cast<uint32_t>(config.opponents.size()))];
+        players[seat].epsilon = 0.1f;
+    }
+    players[me] = params;
+    players[me].epsilon = 0;
+
+    GameState s = GameState::initial(roles);
+    for (int ply = 0; ply < MAX_PLIES && !s.is_terminal(); ++ply) {
+        s.apply(heuristic_action(s, players[s.to_move], rng));
+    }
+    return final_rewards(s)[me];
+}
+
+double Tuner::fitness(const HeuristicParams& params, int g) const {
+    double total = 0;
+    for (int game = 0; game < config.games; ++game) total += play(params, g, game);
+    return total / config.games;
+}
+
+void Tuner::score(int g) {
+    const int batches = (config.games + config.batch - 1) / config.batch;
+    vector<double> sums(pop.size() * batches, 0.0);
+    WorkStealingPool pool(config.threads);
+    for (size_t c = 0; c < pop.size(); ++c) {
+        for (int b = 0; b < batches; ++b) {
+            pool.submit([this, &sums, c, b, batches, g] {
+                const HeuristicParams params = from_genes(pop[c].genes);
+                const int first = b * config.batch;
+                const int last = min(first + config.batch, config.games);
+                double sum = 0;
+                for (int game = first; game < last; ++game) sum += play(params, g, game);
+                sums[c * batches + b] = sum;
+            });
+        }
+    }
+    pool.wait();
+    for (size_t c = 0; c < pop.size(); ++c) {
+        double sum = 0;
+        for (int b = 0; b < batches; ++b) sum += sums[c * batches + b];
+        pop[c].fitness = sum / config.games;
+    }
+}
+
+void Tuner::breed(int g) {
+    FastRng rng(config.seed * GOLDEN ^ (static_cast<uint64_t>(g) << 32 | 0xb5eed));
+    sort(pop.begin(), pop.end(), [](const Candidate& a, const Candidate& b) { return a.fitness > b.fitness; });
+    auto pick = [&]() -> const Candidate& {  // best of three at random
+        const Candidate* best = &pop[rng.below(static_cast<uint32_t>(pop.size()))];
+        for (int i = 0; i < 2; ++i) {
+            const Candidate* c = &pop[rng.below(static_cast<uint32_t>(pop.size()))];
+            if (c->fitness > best->fitness) best = c;
+        }
+        return *best;
+    };
+    vector<Candidate> next(pop.begin(), pop.begin() + config.elite);
+    while (static_cast<int>(next.size()) < config.population) {
+        const Candidate& a = pick();
+        const Candidate& b = pick();
+        Candidate child;
+        for (int i = 0; i < NUM_GENES; ++i) child.genes[i] = (rng.next() & 1) ? a.genes[i] : b.genes[i];
+        child.genes = mutate(child.genes, config, rng);
+        next.push_back(child);
+    }
+    pop = move(next);
+}
+
+void Tuner::run(int generations, ostream* progress) {
+    for (int i = 0; i < generations; ++i) {
+        if (gen > 0) breed(gen);
+        score(gen);
+        ++gen;
+        if (!config.checkpoint.empty()) save();
+        if (progress) {
+            double mean = 0;
+            for (const Candidate& c : pop) mean += c.fitness;
+            *progress << "generation " << gen << ": best " << best().fitness << ", mean "
+                      << mean / static_cast<double>(pop.size()) << endl;
+        }
+    }
+}
+
+const Candidate& Tuner::best() const {
+    return *max_element(pop.begin(), pop.end(),
+                        [](const Candidate& a, const Candidate& b) { return a.fitness < b.fitness; });
+}
+
+// Text, one candidate per line: fitness then genes. Written beside the
+// target and renamed, so an interrupted save keeps the previous checkpoint.
+void Tuner::save() const {
+    const string tmp = config.checkpoint + ".tmp";
+    {
+        ofstream out(tmp, ios::trunc);
+        out << "coup-tuner " << FORMAT_VERSION << ' ' << NUM_GENES << '\n'
+            << gen << ' ' << pop.size() << '\n' << setprecision(17);
+        for (const Candidate& c : pop) {
+            out << c.fitness;
+            for (float x : c.genes) out << ' ' << x;
+            out << '\n';
+        }
+        if (!out) throw runtime_error("Cannot write " + tmp);
+    }
+    if (rename(tmp.c_str(), config.checkpoint.c_str()) != 0) throw runtime_error("Cannot write " + config.checkpoint);
+}
+
+bool Tuner::load() {
+    if (config.checkpoint.empty()) return false;
+    ifstream in(config.checkpoint);
+    if (!in) return false;
+    string magic;
+    int version = 0, genes = 0;
+    size_t size = 0;
+    if (!(in >> magic >> version >> genes >> gen >> size) || magic != "coup-tuner"
+        || version != FORMAT_VERSION || genes != NUM_GENES || static_cast<int>(size) != config.population) {
+        throw runtime_error(config.checkpoint + " is not a checkpoint for this configuration.");
+    }
+    pop.assign(size, Candidate());
+    for (Candidate& c : pop) {
+        in >> c.fitness;
+        for (float& x : c.genes) in >> x;
+    }
+    if (!in) throw runtime_error(config.checkpoint + " is truncated.");
+    return true;
+}
+
+}
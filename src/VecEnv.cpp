@@ -0,0 +1,124 @@
+// Email: adhamhamoudy3@gmail.com
+#include "VecEnv.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+int slot_of(const GameState& s, int seat) {
+    return (seat - s.to_move + s.num_seats) % s.num_seats;
+}
+
+int seat_of(const GameState& s, int slot) {
+    return (s.to_move + slot) % s.num_seats;
+}
+
+} // namespace
+
+int encode_action(const GameState& s, const Action& a) {
+    const int slot = needs_target(a.type) ? slot_of(s, a.target) : 0;
+    return static_cast<int>(a.type) * MAX_PLAYERS + slot;
+}
+
+Action decode_action(const GameState& s, int index) {
+    Action a{static_cast<ActionType>(index / MAX_PLAYERS), s.to_move, NO_SEAT};
+    const int slot = index % MAX_PLAYERS;
+    if (needs_target(a.type) && slot < s.num_seats) a.target = static_cast<uint8_t>(seat_of(s, slot));
+    return a;
+}
+
+void write_observation(const GameState& s, bool full_information, float* obs) {
+    fill(obs, obs + OBS_SIZE, 0.0f);
+    for (int slot = 0; slot < s.num_seats; ++slot) {
+        const int seat = seat_of(s, slot);
+        const uint8_t bit = static_cast<uint8_t>(1u << seat);
+        float* f = obs + slot * OBS_SEAT_FEATURES;
+        f[0] = (s.alive & bit) != 0;
+        if (slot == 0 || full_information) {
+            f[1] = static_cast<float>(s.coins[seat]) / 10;
+            f[2 + static_cast<int>(s.roles[seat])] = 1;
+        }
+        f[2 + NUM_ROLES] = (s.arrested & bit) != 0;
+        f[3 + NUM_ROLES] = (s.sanctioned & bit) != 0;
+        f[4 + NUM_ROLES] = s.last_action[seat] == static_cast<uint8_t>(ActionType::Tax);
+    }
+    float* tail = obs + MAX_PLAYERS * OBS_SEAT_FEATURES;
+    tail[0] = (s.bribed >> s.to_move) & 1;
+    if (s.last_target[s.to_move] != NO_SEAT) tail[1 + slot_of(s, s.last_target[s.to_move])] = 1;
+}
+
+VecEnv::VecEnv(const VecEnvConfig& config) : config(config), states(max(config.num_envs, 0)), rng(config.seed) {
+    if (config.num_envs < 1 || config.num_seats < 2 || config.num_seats > MAX_PLAYERS) {
+        throw runtime_error("A VecEnv needs at least one env of 2-6 seats.");
+    }
+    for (int i = 0; i < config.num_envs; ++i) deal(i);
+}
+
+void VecEnv::deal(int env) {
+    vector<Role> roles(config.num_seats);
+    for (Role& r : roles) r = static_cast<Role>(rng.below(NUM_ROLES));
+    states[env] = GameState::initial(roles);
+}
+
+void VecEnv::write_obs(int env, float* obs) const {
+    write_observation(states[env], config.full_information, obs);
+}
+
+void VecEnv::write_mask(int env, uint8_t* mask) const {
+    const GameState& s = states[env];
+    fill(mask, mask + NUM_ENV_ACTIONS, uint8_t{0});
+    ActionList legal;
+    s.legal_actions(legal);
+    for (const Action& a : legal) mask[encode_action(s, a)] = 1;
+}
+
+void VecEnv::write(int env, const EnvBuffers& out) const {
+    if (out.obs) write_obs(env, out.obs + static_cast<size_t>(env) * OBS_SIZE);
+    if (out.masks) write_mask(env, out.masks + static_cast<size_t>(env) * NUM_ENV_ACTIONS);
+    if (out.seats) out.seats[env] = states[env].to_move;
+}
+
+void VecEnv::reset(const EnvBuffers& out) {
+    for (int i = 0; i < config.num_envs; ++i) {
+        deal(i);
+        write(i, out);
+        if (out.rewards) fill(out.rewards + i * MAX_PLAYERS, out.rewards + (i + 1) * MAX_PLAYERS, 0.0f);
+        if (out.dones) out.dones[i] = 0;
+    }
+}
+
+void VecEnv::step(const int32_t* actions, const EnvBuffers& out) {
+    // Check every action first, so a bad one leaves all games untouched
+    for (int i = 0; i < config.num_envs; ++i) {
+        const GameState& s = states[i];
+        if (actions[i] < 0 || actions[i] >= NUM_ENV_ACTIONS || !s.is_legal(decode_action(s, actions[i]))
+            || encode_action(s, decode_action(s, actions[i])) != actions[i]) {
+            throw runtime_error("Illegal action index " + to_string(actions[i]) + " in env " + to_string(i) + ".");
+        }
+    }
+    for (int i = 0; i < config.num_envs; ++i) {
+        GameState& s = states[i];
+        s.apply(decode_action(s, actions[i]));
+
+        const bool done = s.is_terminal() || s.ply >= config.max_plies;
+        float* reward = out.rewards ? out.rewards + i * MAX_PLAYERS : nullptr;
+        if (reward) {
+            if (done) {
+                const Rewards r = final_rewards(s);
+                copy(r.begin(), r.end(), reward);
+            } else {
+                fill(reward, reward + MAX_PLAYERS, 0.0f);
+            }
+        }
+        if (out.dones) out.dones[i] = done;
+        if (done) deal(i);
+        write(i, out);
+    }
+}
+
+}
@@ -0,0 +1,109 @@
+// Email: adhamhamoudy3@gmail.com
+#include "WorkStealingPool.hpp"
+
+using namespace std;
+
+namespace coup {
+
+namespace {
+
+// Index of the pool worker running on this thread, or -1.
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local int current_worker = -1;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) threads = thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (unsigned t = 0; t < threads; ++t) queues.push_back(make_unique<Queue>());
+    for (unsigned t = 0; t < threads; ++t) workers.emplace_back(&WorkStealingPool::work, this, t);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        unique_lock<mutex> guard(state_lock);
+        idle.wait(guard, [&] { return pending == 0; });
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+void WorkStealingPool::submit(function<void()> task) {
+    unsigned target = current_pool == this
+        ? static_cast<unsigned>(current_worker)
+        : next_queue.fetch_add(1, memory_order_relaxed) % size();
+    ++pending;
+    {
+        lock_guard<mutex> guard(queues[target]->lock);
+        queues[target]->tasks.push_back(move(task));
+    }
+    {
+        // Under the lock, so a worker about to sleep cannot miss it
+        lock_guard<mutex> guard(state_lock);
+        ++queued;
+    }
+    wake.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    unique_lock<mutex> guard(state_lock);
+    idle.wait(guard, [&] { return pending == 0; });
+    if (error) {
+        exception_ptr e = error;
+        error = nullptr;
+        rethrow_exception(e);
+    }
+}
+
+bool WorkStealingPool::take(unsigned self, function<void()>& task) {
+    {
+        Queue& own = *queues[self];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+            --queued;
+            return true;
+        }
+    }
+    for (unsigned i = 1; i < size(); ++i) {
+        Queue& victim = *queues[(self + i) % size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::work(unsigned self) {
+    current_pool = this;
+    current_worker = static_cast<int>(self);
+    function<void()> task;
+    while (true) {
+        if (!take(self, task)) {
+            unique_lock<mutex> guard(state_lock);
+            wake.wait(guard, [&] { return stopping || queued > 0; });
+            if (stopping && queued == 0) return;
+            continue;
+        }
+        try {
+            task();
+        } catch (...) {
+            lock_guard<mutex> guard(state_lock);
+            if (!error) error = current_exception();
+        }
+        task = nullptr;
+        if (--pending == 0) {
+            lock_guard<mutex> guard(state_lock);
+            idle.notify_all();
+        }
+    }
+}
+
+}
@@ -0,0 +1,82 @@
+// Email: adhamhamoudy3@gmail.com
+#include "coup_env.h"
+#include "VecEnv.hpp"
+
+#include <exception>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace coup;
+
+// No exception may cross the C boundary: every entry point catches and
+// keeps the message for coup_env_last_error().
+struct coup_env {
+    unique_ptr<VecEnv> env;
+    string error;
+};
+
+extern "C" {
+
+int coup_env_obs_size(void) {
+    return OBS_SIZE;
+}
+
+int coup_env_num_actions(void) {
+    return NUM_ENV_ACTIONS;
+}
+
+int coup_env_max_players(void) {
+    return MAX_PLAYERS;
+}
+
+coup_env* coup_env_create(int num_envs, int num_seats, int max_plies, int full_information, uint64_t seed) {
+    try {
+        VecEnvConfig config;
+        config.num_envs = num_envs;
+        config.num_seats = num_seats;
+        config.max_plies = max_plies;
+        config.full_information = full_information != 0;
+        config.seed = seed;
+        auto handle = make_unique<coup_env>();
+        handle->env = make_unique<VecEnv>(config);
+        return handle.release();
+    } catch (const exception&) {
+        return nullptr;
+    }
+}
+
+void coup_env_destroy(coup_env* env) {
+    delete env;
+}
+
+int coup_env_reset(coup_env* env, float* obs, uint8_t* masks, int32_t* seats) {
+    try {
+        EnvBuffers out;
+        out.obs = obs;
+        out.masks = masks;
+        out.seats = seats;
+        env->env->reset(out);
+        return 0;
+    } catch (const exception& e) {
+        env->error = e.what();
+        return -1;
+    }
+}
+
+int coup_env_step(coup_env* env, const int32_t* actions, float* obs, uint8_t* masks, float* rewards,
+                  uint8_t* dones, int32_t* seats) {
+    try {
+        env->env->step(actions, EnvBuffers{obs, masks, rewards, dones, seats});
+        return 0;
+    } catch (const exception& e) {
+        env->error = e.what();
+        return -1;
+    }
+}
+
+const char* coup_env_last_error(const coup_env* env) {
+    return env->error.c_str();
+}
+
+}
@@ -6,9 +6,47 @@
 #include "../include/Governor.hpp"
 #include "../include/Spy.hpp"
 #include "../include/Baron.hpp"
+#include "../include/BeliefTracker.hpp"
 #include "../include/General.hpp"
 #include "../include/Judge.hpp"
 #include "../include/Merchant.hpp"
+#include "../include/Fuzz.hpp"
+#include "../include/GameState.hpp"
+#include "../include/GameBridge.hpp"
+#include "../include/Differential.hpp"
+#include "../include/Perft.hpp"
+#include "../include/AlphaBeta.hpp"
+#include "../include/BestResponse.hpp"
+#include "../include/Cfr.hpp"
+#include "../include/HeuristicBot.hpp"
+#include "../include/MctsBot.hpp"
+#include "../include/Tablebase.hpp"
+#include "../include/IsmctsBot.hpp"
+#include "../include/OpeningBook.hpp"
+#include "../include/Replay.hpp"
+#include "../include/ReplayCorpus.hpp"
+#include "../include/SelfPlayRing.hpp"
+#include "../include/Tournament.hpp"
+#include "../include/Tuner.hpp"
+#include "../include/VecEnv.hpp"
+#include "../include/WorkStealingPool.hpp"
+#include "../include/coup_env.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace coup;
 
@@ -201,3 +239,1246 @@ TEST_CASE("Eliminated player cannot perform actions") {
     CHECK_THROWS(player.sanction(enemy));
     CHECK_THROWS(player.coup(enemy));
 }
+
+
+TEST_CASE("Merchant bonus is granted once, when the turn starts") {
+    Game g;
+    Merchant merchant(g, "Merchant");
+    Governor gov(g, "Gov");
+
+    merchant.add_coins(3);
+    g.advance_turn();  // to Gov
+    g.advance_turn();  // back to Merchant: +1
+    CHECK(merchant.coins() == 4);
+
+    // Validating again (even through a failing action) adds nothing
+    CHECK_THROWS(merchant.coup(gov));
+    CHECK_NOTHROW(merchant.validate_turn());
+    CHECK_NOTHROW(merchant.validate_turn());
+    CHECK(merchant.coins() == 4);
+}
+
+TEST_CASE("Rejected actions leave the game untouched") {
+    Game g;
+    Governor gov(g, "Gov");
+    Judge judge(g, "Judge");
+    Spy spy(g, "Spy");
+
+    CHECK_THROWS(gov.arrest(spy));  // Spy has nothing to take
+    CHECK_FALSE(spy.is_arrested());
+    CHECK(gov.get_last_action() == "");
+
+    gov.add_coins(3);
+    CHECK_THROWS(gov.sanction(judge));  // Judge costs one extra coin
+    CHECK_FALSE(judge.is_sanctioned());
+    CHECK(gov.coins() == 3);
+
+    CHECK_THROWS(gov.coup(spy));
+    CHECK(gov.get_last_action() == "");
+}
+
+TEST_CASE("Fuzz harness holds its invariants on random inputs") {
+    std::mt19937 rng(2024);
+    std::vector<uint8_t> input;
+    const uint64_t abandoned_before = abandoned_playouts();
+    for (int i = 0; i < 2000; ++i) {
+        input.resize(2 + rng() % 64);
+        for (auto& b : input) b = static_cast<uint8_t>(rng());
+        CHECK_NOTHROW(fuzz_one_input(input.data(), input.size()));
+    }
+    CHECK((abandoned_playouts() - abandoned_before) * 100 <= 2000 * MAX_ABANDONED_PERCENT);
+}
+
+TEST_CASE("Governor cannot undo the same tax twice") {
+    Game g;
+    Spy spy(g, "Spy");
+    Governor gov(g, "Gov");
+
+    spy.tax();
+    CHECK_NOTHROW(gov.undo(spy));
+    CHECK(spy.coins() == 0);
+    CHECK_THROWS(gov.undo(spy));
+}
+
+TEST_CASE("GameState follows the role rules") {
+    GameState s = GameState::initial({Role::Merchant, Role::General, Role::Judge});
+    ActionList legal;
+    s.legal_actions(legal);
+    CHECK(legal.size() == 2);  // gather and tax; nobody has a coin to arrest
+
+    s.coins = {3, 5, 3};
+    s.apply({ActionType::Gather, 0, NO_SEAT});   // Merchant 4, General to move
+    CHECK_FALSE(s.is_legal({ActionType::Coup, 1, 0}));
+    s.apply({ActionType::Sanction, 1, 2});       // sanctioning a Judge costs 4
+    CHECK(s.coins[1] == 1);
+    CHECK(s.is_legal({ActionType::Skip, 2, NO_SEAT}));
+    s.apply({ActionType::Skip, 2, NO_SEAT});
+    CHECK(s.to_move == 0);
+    CHECK(s.coins[0] == 5);  // Merchant bonus at the start of the turn
+}
+
+TEST_CASE("GameState matches Game/Player in lockstep") {
+    for (uint64_t seed = 1; seed <= 300; ++seed) {
+        LockstepResult result = run_lockstep(seed, 400);
+        CHECK(result.actions > 0);
+        if (result.divergence) {
+            FAIL(describe(minimize(*result.divergence)));
+        }
+    }
+}
+
+TEST_CASE("GameState converts from a running Game") {
+    Game g;
+    Governor gov(g, "Gov");
+    Baron baron(g, "Baron");
+
+    gov.gather();
+    baron.add_coins(3);
+    GameState s = state_from_game(g);
+    CHECK(s.num_seats == 2);
+    CHECK(s.to_move == 1);
+    CHECK(s.coins[0] == 1);
+    CHECK(s.roles[1] == Role::Baron);
+    CHECK(s.is_legal({ActionType::Invest, 1, NO_SEAT}));
+
+    perform({ActionType::Invest, 1, NO_SEAT}, g.player_list());
+    CHECK(baron.coins() == 6);
+    CHECK(g.turn() == "Gov");
+}
+
+TEST_CASE("Perft counts match in every mode") {
+    GameState start = GameState::initial({Role::Governor, Role::Spy, Role::Baron,
+                                          Role::General, Role::Judge, Role::Merchant});
+    ActionList legal;
+    start.legal_actions(legal);
+    CHECK(perft(start, 0).nodes == 1);
+    CHECK_THROWS_AS(perft(start, -1), std::runtime_error);
+    CHECK(perft_divide(start, 0).empty());
+    CHECK_THROWS_AS(perft_divide(start, -1), std::runtime_error);
+    CHECK(perft(start, 1).nodes == static_cast<uint64_t>(legal.size()));
+
+    PerftResult serial = perft(start, 7);
+    CHECK(serial.nodes == 93637);  // reference value; a change means the rules changed
+    CHECK(serial.by_type[static_cast<int>(ActionType::Undo)] == 6178);
+
+    PerftOptions parallel;
+    parallel.threads = 3;
+    CHECK(perft(start, 7, parallel) == serial);
+
+    PerftOptions hashed;
+    hashed.table_mb = 1;
+    CHECK(perft(start, 7, hashed) == serial);
+}
+
+TEST_CASE("MctsBot finds the winning coup") {
+    GameState s = GameState::initial({Role::Governor, Role::Merchant});
+    s.coins = {7, 9};  // the Merchant would coup next turn
+
+    MctsConfig config;
+    config.iterations = 2000;
+    config.threads = 2;
+    config.seed = 7;
+    config.endgame_depth = 0;  // test the tree search itself
+    MctsBot bot(config);
+    Action a = bot.choose(s);
+    CHECK(a.type == ActionType::Coup);
+    CHECK(a.target == 1);
+
+    uint64_t total = 0;
+    for (const auto& entry : bot.last_visits()) total += entry.second;
+    CHECK(total == 2000);  // both trees merged at the root
+}
+
+TEST_CASE("MctsBot plays turns of a running Game") {
+    Game g;
+    Baron baron(g, "Baron");
+    General general(g, "General");
+
+    MctsConfig config;
+    config.iterations = 300;
+    config.seed = 11;
+    MctsBot bot(config);
+    for (int turn = 0; turn < 40 && g.players().size() > 1; ++turn) {
+        CHECK_NOTHROW(play_turn(bot, g));
+    }
+    CHECK(baron.coins() >= 0);
+    CHECK(general.coins() >= 0);
+}
+
+TEST_CASE("MctsBot keeps its tree between turns of a running Game") {
+    Game g;
+    Governor governor(g, "Governor");
+    Baron baron(g, "Baron");
+    Spy spy(g, "Spy");
+
+    MctsConfig config;
+    config.iterations = 2000;
+    config.endgame_depth = 0;
+    config.seed = 12;
+    MctsBot bot(config);
+    HeuristicBot other("other", HeuristicParams::economic(), 3);
+    std::streambuf* saved = std::cerr.rdbuf(nullptr);  // Spy::spy_on prints
+    int decisions = 0;
+    for (int turn = 0; turn < 30 && g.players().size() > 1 && decisions < 4; ++turn) {
+        if (g.turn() == "Governor") {
+            play_turn(bot, g);
+            uint64_t total = 0;
+            for (const auto& entry : bot.last_visits()) total += entry.second;
+            if (decisions++ > 0) CHECK(total > 2000);  // continued from the kept subtree
+        } else {
+            play_turn(other, g);
+        }
+        CHECK(state_from_players(g, g.seats()).ply == g.history().size());
+    }
+    std::cerr.rdbuf(saved);
+    CHECK(decisions > 1);
+
+    // The history replays to the same position
+    GameState replayed = GameState::initial({Role::Governor, Role::Baron, Role::Spy});
+    for (const Action& a : g.history()) {
+        REQUIRE(replayed.is_legal(a));
+        replayed.apply(a);
+    }
+    CHECK(replayed.hash() == state_from_players(g, g.seats()).hash());
+}
+
+TEST_CASE("Tree-parallel MCTS shares one tree across threads") {
+    GameState s = GameState::initial({Role::Governor, Role::Merchant});
+    s.coins = {7, 9};
+
+    MctsConfig config;
+    config.iterations = 2000;
+    config.threads = 4;
+    config.parallelism = Parallelism::Tree;
+    config.virtual_loss = 3;
+    config.seed = 7;
+    config.endgame_depth = 0;  // test the tree search itself
+    MctsBot bot(config);
+    Action a = bot.choose(s);
+    CHECK(a.type == ActionType::Coup);
+    CHECK(bot.last_playouts() == 2000);
+
+    uint64_t total = 0;
+    for (const auto& entry : bot.last_visits()) total += entry.second;
+    CHECK(total == 2000);  // every virtual loss was paid back
+
+    config.max_nodes = 1;  // pool too small to grow past the root
+    MctsBot small(config);
+    CHECK(small.choose(s).type == ActionType::Coup);
+}
+
+TEST_CASE("MctsBot stays under its node cap and reuses its tree") {
+    GameState s = GameState::initial({Role::Governor, Role::Baron});
+
+    MctsConfig config;
+    config.iterations = 3000;
+    config.max_nodes = 400;
+    config.seed = 13;
+    config.endgame_depth = 0;  // test the tree search itself
+    MctsBot bounded(config);
+    Action first = bounded.choose(s);
+    CHECK(bounded.nodes_in_use() <= 400);
+    CHECK(s.is_legal(first));
+
+    config.max_nodes = 1 << 20;
+    MctsBot bot(config);
+    Action a = bot.choose(s);
+    s.apply(a);
+    ActionList legal;
+    s.legal_actions(legal);
+    s.apply(legal[0]);
+
+    auto total_visits = [](const MctsBot& b) {
+        uint64_t total = 0;
+        for (const auto& entry : b.last_visits()) total += entry.second;
+        return total;
+    };
+    bot.choose(s);
+    CHECK(total_visits(bot) > 3000);  // continued from the kept subtree
+
+    config.reuse_tree = false;
+    MctsBot fresh(config);
+    fresh.choose(s);
+    CHECK(total_visits(fresh) == 3000);
+}
+
+TEST_CASE("Alpha-beta solves two-player endgames") {
+    GameState s = GameState::initial({Role::Governor, Role::Spy, Role::Merchant});
+    CHECK_THROWS(AlphaBeta().search(s));
+
+    s = GameState::initial({Role::Governor, Role::Merchant});
+    s.coins = {6, 9};  // tax reaches 9, but the Merchant coups first
+    AlphaBetaConfig config;
+    config.max_depth = 8;
+    AlphaBetaResult lost = AlphaBeta(config).search(s);
+    CHECK(lost.proven());
+    CHECK(lost.score < 0);
+
+    s.coins = {7, 9};
+    config.threads = 3;
+    AlphaBeta solver(config);
+    AlphaBetaResult won = solver.search(s);
+    CHECK(won.proven());
+    CHECK(won.score == AlphaBeta::WIN - 1);
+    CHECK(won.best.type == ActionType::Coup);
+    CHECK(solver.search(s).best == won.best);  // answered again from the table
+
+    MctsConfig mcts;
+    mcts.seed = 3;
+    MctsBot bot(mcts);
+    CHECK(bot.choose(s).type == ActionType::Coup);
+    CHECK(bot.last_endgame().proven());
+    CHECK(bot.last_playouts() == 0);
+}
+
+TEST_CASE("Tablebase build resumes and agrees with alpha-beta") {
+    std::string path = (std::filesystem::temp_directory_path() / "coup_test.tb").string();
+    std::string reference = path + ".ref";
+    std::filesystem::remove(path);
+    std::filesystem::remove(reference);
+
+    TablebaseConfig config;
+    config.role_pairs = 1ULL << (static_cast<int>(Role::Governor) * NUM_ROLES + static_cast<int>(Role::Merchant));
+    config.coin_cap = 12;
+    config.threads = 2;
+    uint64_t solved = build_tablebase(reference, config);
+
+    config.max_passes = 3;  // stop early, as if interrupted
+    build_tablebase(path, config);
+    CHECK_THROWS(Tablebase{path});
+    {
+        // ... in the middle of pass 4: a few of its results written, the header not
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        int written = 0;
+        for (std::streamoff pos = 64; written < 8 && f.seekg(pos) && f.peek() != EOF; pos += 97) {
+            if (f.peek() != 0) continue;
+            f.seekp(pos);
+            f.put(static_cast<char>(written++ % 2 ? 0x84 : 4));
+        }
+        REQUIRE(written == 8);
+    }
+    config.max_passes = 127;
+    CHECK(build_tablebase(path, config) == solved);
+
+    std::ifstream a(path, std::ios::binary), b(reference, std::ios::binary);
+    std::string bytes_a((std::istreambuf_iterator<char>(a)), {});
+    std::string bytes_b((std::istreambuf_iterator<char>(b)), {});
+    CHECK(bytes_a == bytes_b);
+
+    Tablebase table(path);
+    GameState s = GameState::initial({Role::Governor, Role::Merchant});
+    s.coins = {6, 9};
+    TablebaseProbe lost = table.probe(s);
+    CHECK(lost.outcome == Outcome::Loss);
+
+    AlphaBetaConfig ab;
+    ab.max_depth = lost.distance;
+    AlphaBetaResult r = AlphaBeta(ab).search(s);
+    CHECK(r.proven());
+    CHECK(r.score == -(AlphaBeta::WIN - lost.distance));
+
+    s.coins = {7, 9};
+    CHECK(table.probe(s).outcome == Outcome::Win);
+    MctsConfig mcts;
+    mcts.tablebase = &table;
+    mcts.endgame_depth = 0;
+    mcts.seed = 3;
+    MctsBot bot(mcts);
+    CHECK(bot.choose(s).type == ActionType::Coup);
+    CHECK(bot.last_playouts() == 0);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(reference);
+}
+
+TEST_CASE("CFR solver trains a loadable policy") {
+    CfrConfig config;
+    config.threads = 2;
+    config.horizon = 3;
+    CfrSolver solver(config);
+    solver.run(300);
+    CHECK(solver.iterations() == 300);
+    CHECK(solver.regret_bound() > 0);
+
+    std::string path = (std::filesystem::temp_directory_path() / "coup_test.policy").string();
+    solver.policy().save(path);
+    CfrPolicy loaded(path);
+    std::filesystem::remove(path);
+
+    GameState s = GameState::initial({Role::Baron, Role::Judge});
+    s.coins = {3, 2};
+    ActionList legal;
+    s.legal_actions(legal);
+    float trained[MAX_ACTIONS], saved[MAX_ACTIONS];
+    solver.policy().distribution(s, legal, trained);
+    loaded.distribution(s, legal, saved);
+    float total = 0;
+    for (int i = 0; i < legal.size(); ++i) {
+        CHECK(trained[i] == saved[i]);
+        total += saved[i];
+    }
+    CHECK(total == doctest::Approx(1.0));
+
+    PolicyBot bot(loaded, 5);
+    CHECK(s.is_legal(bot.choose(s)));
+}
+
+TEST_CASE("Best response exploits a uniform policy") {
+    UniformPolicy uniform;
+    GameState s = GameState::initial({Role::Governor, Role::Merchant});
+    s.coins = {7, 9};
+    BestResponseConfig config;
+    config.depth = 1;
+    CHECK(best_response_value(uniform, s, 0, config) == 1.0);  // coup now
+    s.to_move = 1;
+    CHECK(best_response_value(uniform, s, 0, config) == doctest::Approx(-1.0 / 6));  // coups 1 time in 6
+
+    config.depth = 8;
+    ExploitabilityResult serial = exploitability(uniform, config);
+    config.threads = 3;
+    ExploitabilityResult parallel = exploitability(uniform, config);
+    CHECK(serial.value > 0);
+    CHECK(parallel.value == doctest::Approx(serial.value));
+}
+
+TEST_CASE("Heuristic bots play to their style") {
+    GameState s = GameState::initial({Role::Baron, Role::Spy, Role::Judge});
+    s.coins = {7, 2, 5};
+
+    HeuristicBot greedy("greedy", HeuristicParams::greedy());
+    HeuristicBot economic("economic", HeuristicParams::economic());
+    HeuristicBot aggressive("aggressive", HeuristicParams::aggressive());
+    CHECK(greedy.choose(s) == Action{ActionType::Coup, 0, 2});  // richest target
+    CHECK(economic.choose(s).type == ActionType::Invest);
+    s.coins[0] = 2;
+    CHECK(aggressive.choose(s) == Action{ActionType::Arrest, 0, 2});
+
+    // As rollout policies they only ever produce legal moves
+    FastRng rng(4);
+    for (RolloutPolicy policy : {RolloutPolicy::Greedy, RolloutPolicy::Economic, RolloutPolicy::Aggressive}) {
+        GameState g = GameState::initial({Role::Governor, Role::Spy, Role::Baron, Role::General});
+        for (int ply = 0; ply < 200 && !g.is_terminal(); ++ply) {
+            Action a = rollout_action(g, policy, rng);
+            REQUIRE(g.is_legal(a));
+            g.apply(a);
+        }
+    }
+}
+
+TEST_CASE("Observation narrows hidden roles from public actions") {
+    GameState s = GameState::initial({Role::Governor, Role::Baron, Role::Spy});
+    s.coins = {0, 3, 0};
+    Observation obs(s, 0, 5);
+    CHECK(obs.possible_roles(0) == (1 << static_cast<int>(Role::Governor)));
+    CHECK(obs.possible_roles(1) != (1 << static_cast<int>(Role::Baron)));
+
+    Action gather{ActionType::Gather, 0, NO_SEAT};
+    s.apply(gather);
+    obs.record(gather, s);
+    Action invest{ActionType::Invest, 1, NO_SEAT};
+    s.apply(invest);
+    obs.record(invest, s);
+    CHECK(obs.possible_roles(1) == (1 << static_cast<int>(Role::Baron)));
+
+    // Determinizations keep public fields and the viewer's seat, and never
+    // copy a hidden coin count from the true state
+    FastRng rng(3);
+    GameState d = obs.determinize(s, rng);
+    CHECK(d.to_move == s.to_move);
+    CHECK(d.roles[1] == Role::Baron);
+    CHECK(d.coins[0] == s.coins[0]);
+}
+
+TEST_CASE("Determinizations do not leak a Governor's unset last action") {
+    // A Governor's tax leaves last action unset, so a seat sampled as any
+    // other role must show the tax it would have recorded
+    GameState s = GameState::initial({Role::Governor, Role::Governor, Role::Spy});
+    Observation obs(s, 0, 7);
+    for (Action a : {Action{ActionType::Gather, 0, NO_SEAT}, Action{ActionType::Tax, 1, NO_SEAT},
+                     Action{ActionType::Gather, 2, NO_SEAT}}) {
+        REQUIRE(s.is_legal(a));
+        s.apply(a);
+        obs.record(a, s);
+    }
+    REQUIRE(s.last_action[1] == NO_ACTION);
+    const Action undo{ActionType::Undo, 0, 1};
+    REQUIRE_FALSE(s.is_legal(undo));
+
+    FastRng rng(9);
+    int governors = 0;
+    for (int i = 0; i < 200; ++i) {
+        GameState d = obs.determinize(s, rng);
+        const bool taxed = d.last_action[1] == static_cast<uint8_t>(ActionType::Tax);
+        CHECK(taxed == (d.roles[1] != Role::Governor));
+        governors += d.roles[1] == Role::Governor;
+    }
+    CHECK(governors < 200);
+
+    // Undo is legal in some determinizations but not at the table, so the
+    // search never spends a playout on it
+    MctsConfig config;
+    config.iterations = 500;
+    config.threads = 1;
+    config.seed = 2;
+    IsmctsBot bot(config);
+    bot.on_game_start(GameState::initial({Role::Governor, Role::Governor, Role::Spy}), 0);
+    GameState replay = GameState::initial({Role::Governor, Role::Governor, Role::Spy});
+    for (Action a : {Action{ActionType::Gather, 0, NO_SEAT}, Action{ActionType::Tax, 1, NO_SEAT},
+                     Action{ActionType::Gather, 2, NO_SEAT}}) {
+        replay.apply(a);
+        bot.on_action(a, replay);
+    }
+    CHECK(bot.choose(s) != undo);
+    uint64_t counted = 0;
+    for (const auto& [action, n] : bot.last_visits()) counted += n;
+    CHECK(counted == bot.last_playouts());
+}
+
+TEST_CASE("Belief tracker weighs roles and coins from observed actions") {
+    GameState s = GameState::initial({Role::Governor, Role::Baron, Role::Judge});
+    s.coins = {4, 3, 0};
+    BeliefTracker hidden(s, 0);
+    CHECK(hidden.role_probability(0, Role::Governor) == 1.0f);
+    CHECK(hidden.role_probability(1, Role::Baron) == doctest::Approx(1.0 / 6));
+
+    // The viewer pays 4 to sanction a Judge, and only a Baron invests
+    for (Action a : {Action{ActionType::Sanction, 0, 2}, Action{ActionType::Invest, 1, NO_SEAT},
+                     Action{ActionType::Skip, 2, NO_SEAT}, Action{ActionType::Gather, 0, NO_SEAT},
+                     Action{ActionType::Tax, 1, NO_SEAT}}) {
+        REQUIRE(s.is_legal(a));
+        s.apply(a);
+        hidden.observe(a, s);
+    }
+    CHECK(hidden.role_probability(2, Role::Judge) == doctest::Approx(1.0));
+    CHECK(hidden.likely_role(1) == Role::Baron);
+    CHECK(hidden.coin_probability(1, 8) == doctest::Approx(1.0));
+    CHECK(hidden.summary(1) == "Baron 100% - about 8 coins");
+
+    FastRng rng(4);
+    GameState d = hidden.determinize(s, rng);
+    CHECK(d.roles[1] == Role::Baron);
+    CHECK(d.coins[1] == 8);
+    CHECK(d.coins[0] == s.coins[0]);
+
+    // A 3-coin tax is a Governor's, but only if the coins can be seen
+    GameState t = GameState::initial({Role::Spy, Role::Governor});
+    BeliefTracker unseen(t, 0);
+    BeliefTracker seen(t, 0, true);
+    for (Action a : {Action{ActionType::Gather, 0, NO_SEAT}, Action{ActionType::Tax, 1, NO_SEAT}}) {
+        t.apply(a);
+        unseen.observe(a, t);
+        seen.observe(a, t);
+    }
+    CHECK(unseen.role_probability(1, Role::Governor) == doctest::Approx(1.0 / 6));
+    CHECK(unseen.coin_probability(1, 3) == doctest::Approx(1.0 / 6));
+    CHECK(seen.role_probability(1, Role::Governor) == doctest::Approx(1.0));
+}
+
+TEST_CASE("IsmctsBot does not peek at hidden roles") {
+    MctsConfig config;
+    config.iterations = 600;
+    config.threads = 2;
+    config.seed = 9;
+
+    std::vector<Action> decisions;
+    for (Role hidden : {Role::General, Role::Judge, Role::Merchant}) {
+        GameState s = GameState::initial({Role::Spy, Role::Baron, hidden});
+        IsmctsBot bot(config);
+        bot.on_game_start(s, 0);
+        for (int seat = 0; seat < 3; ++seat) {
+            Action gather{ActionType::Gather, static_cast<uint8_t>(seat), NO_SEAT};
+            s.apply(gather);
+            bot.on_action(gather, s);
+        }
+        Action a = bot.choose(s);
+        CHECK(s.is_legal(a));
+        CHECK(bot.last_playouts() == 600);
+        decisions.push_back(a);
+    }
+    CHECK(decisions[0] == decisions[1]);
+    CHECK(decisions[1] == decisions[2]);
+}
+
+TEST_CASE("play_turn shows bots the table, not the Player objects") {
+    // Records what a bot is told
+    struct Watcher : Bot {
+        GameState start;
+        int seat = -1;
+        std::vector<Action> seen;
+        std::string name() const override { return "watcher"; }
+        Action choose(const GameState& state) override {
+            ActionList legal;
+            state.legal_actions(legal);
+            return legal[0];
+        }
+        void on_game_start(const GameState& s, int at) override {
+            start = s;
+            seat = at;
+            seen.clear();
+        }
+        void on_action(const Action& action, const GameState&) override { seen.push_back(action); }
+    };
+
+    Game g;
+    Governor governor(g, "Governor");
+    Baron baron(g, "Baron");
+    Merchant merchant(g, "Merchant");
+    const GameState dealt = GameState::initial({Role::Governor, Role::Baron, Role::Merchant});
+    HeuristicBot other("other", HeuristicParams::greedy(), 5);
+    MctsConfig config;
+    config.iterations = 200;
+    config.seed = 3;
+    IsmctsBot ismcts(config);
+    Watcher watcher;
+    for (int turn = 0; turn < 20 && g.players().size() > 1; ++turn) {
+        if (g.turn() == "Governor") {
+            play_turn(ismcts, g);
+            // Fed the whole history from the deal, never restarted mid-game
+            CHECK(ismcts.observation().history_size() + 1 == g.history().size());
+            CHECK(ismcts.observation().ply() + 1 == g.history().size());
+        } else if (g.turn() == "Merchant" && turn > 6) {
+            // A bot that joins late still starts from the deal
+            const size_t before = g.history().size();
+            play_turn(watcher, g);
+            CHECK(watcher.seat == 2);
+            CHECK(watcher.start.coins == dealt.coins);
+            CHECK(watcher.start.ply == 0);
+            CHECK(watcher.seen.size() == before);
+            CHECK(std::equal(watcher.seen.begin(), watcher.seen.end(), g.history().begin()));
+        } else {
+            play_turn(other, g);
+        }
+    }
+    CHECK(watcher.seat == 2);
+}
+
+TEST_CASE("Linear evaluator trains and scores leaves in batches") {
+    EvalTrainConfig train;
+    train.games = 300;
+    train.threads = 2;
+    train.epochs = 2;
+    LinearEvaluator eval = train_evaluator(train);
+    for (float w : eval.weights) REQUIRE(std::isfinite(w));
+
+    // The coin features should have learned that money wins
+    GameState s = GameState::initial({Role::Governor, Role::Spy, Role::Baron});
+    s.coins = {9, 1, 1};
+    Rewards r = eval.evaluate(s);
+    CHECK(r[0] > r[1]);
+    CHECK(r[0] + r[1] + r[2] == doctest::Approx(1.0));
+
+    std::vector<GameState> batch;
+    FastRng rng(2);
+    GameState g = GameState::initial({Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge});
+    while (static_cast<int>(batch.size()) < EVAL_BATCH && !g.is_terminal()) {
+        batch.push_back(g);
+        g.apply(rollout_action(g, RolloutPolicy::Random, rng));
+    }
+    std::vector<Rewards> scored(batch.size());
+    eval.evaluate_batch(batch.data(), static_cast<int>(batch.size()), scored.data());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Rewards one = eval.evaluate(batch[i]);
+        for (int seat = 0; seat < MAX_PLAYERS; ++seat) CHECK(scored[i][seat] == doctest::Approx(one[seat]));
+    }
+
+    MctsConfig config;
+    config.iterations = 1000;
+    config.threads = 2;
+    config.seed = 3;
+    config.evaluator = &eval;
+    MctsBot bot(config);
+    CHECK(s.is_legal(bot.choose(s)));
+    CHECK(bot.last_playouts() == 1000);
+}
+
+TEST_CASE("Opening book is keyed by what the mover knows") {
+    OpeningBookConfig config;
+    config.num_seats = 3;
+    config.plies = 3;
+    config.sample_games = 50;
+    config.min_hits = 1;
+    config.deals = 2;
+    config.iterations = 200;
+    config.threads = 2;
+    std::string path = (std::filesystem::temp_directory_path() / "coup_test.book").string();
+    uint64_t entries = build_opening_book(path, config);
+    OpeningBook book(path);
+
+    // An entry count whose size wraps past 64 bits is rejected, not mapped
+    std::string bad = path + ".bad";
+    std::filesystem::copy_file(path, bad, std::filesystem::copy_options::overwrite_existing);
+    {
+        std::fstream f(bad, std::ios::binary | std::ios::in | std::ios::out);
+        uint64_t wrapped = entries + (uint64_t(1) << 60);  // times 16 bytes == entries
+        f.seekp(24);
+        f.write(reinterpret_cast<const char*>(&wrapped), sizeof(wrapped));
+    }
+    CHECK_THROWS_AS(OpeningBook{bad}, std::runtime_error);
+    std::filesystem::remove(bad);
+    std::filesystem::remove(path);  // stays mapped
+    CHECK(entries > 0);
+    CHECK(book.size() == entries);
+
+    // Hidden roles do not change the key; the mover's own role does
+    GameState a = GameState::initial({Role::Spy, Role::Baron, Role::Judge});
+    GameState b = GameState::initial({Role::Spy, Role::Merchant, Role::General});
+    GameState c = GameState::initial({Role::Governor, Role::Baron, Role::Judge});
+    CHECK(OpeningBook::key(a) == OpeningBook::key(b));
+    CHECK(OpeningBook::key(a) != OpeningBook::key(c));
+
+    Action from_a, from_b;
+    REQUIRE(book.lookup(a, from_a));  // every opening starts here
+    REQUIRE(book.lookup(b, from_b));
+    CHECK(from_a == from_b);
+    CHECK(a.is_legal(from_a));
+    a.ply = 3;
+    CHECK_FALSE(book.lookup(a, from_a));  // past the book
+
+    MctsConfig mc;
+    mc.book = &book;
+    MctsBot bot(mc);
+    CHECK(bot.choose(b) == from_b);
+    CHECK(bot.last_playouts() == 0);
+}
+
+TEST_CASE("Bots answer by their deadline") {
+    GameState s = GameState::initial({Role::Governor, Role::Spy, Role::Baron,
+                                      Role::General, Role::Judge, Role::Merchant});
+    MctsConfig config;
+    config.iterations = 0;  // deadline only
+    config.threads = 2;
+    config.seed = 4;
+    for (Parallelism mode : {Parallelism::Root, Parallelism::Tree}) {
+        config.parallelism = mode;
+        MctsBot bot(config);
+        auto begin = std::chrono::steady_clock::now();
+        Action a = bot.decide(s, Deadline::after(std::chrono::milliseconds(30)));
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+        CHECK(s.is_legal(a));
+        CHECK(ms.count() < 250);  // generous for sanitizer and valgrind runs
+    }
+
+    // A cancelled search still returns a legal move
+    std::atomic<bool> stop{true};
+    Deadline cancelled;
+    cancelled.cancel_on(stop);
+    MctsBot mcts(config);
+    CHECK(s.is_legal(mcts.decide(s, cancelled)));
+    CHECK(mcts.last_playouts() == 0);
+    IsmctsBot ismcts(config);
+    CHECK(s.is_legal(ismcts.decide(s, cancelled)));
+
+    GameState duel = GameState::initial({Role::Baron, Role::Judge});
+    AlphaBeta ab;
+    AlphaBetaResult r = ab.search(duel, cancelled);
+    CHECK(r.depth == 0);
+    CHECK(duel.is_legal(r.best));
+}
+
+TEST_CASE("MctsBot ponders on other seats' turns") {
+    MctsConfig config;
+    config.iterations = 300;
+    config.endgame_depth = 0;
+    config.seed = 6;
+    config.ponder = true;
+    MctsBot bot(config);
+    HeuristicBot other("other", HeuristicParams::economic(), 2);
+
+    GameState s = GameState::initial({Role::Governor, Role::Spy, Role::Baron});
+    bot.on_game_start(s, 0);
+    bool waited = false;  // after a bribe the bot moves again at once, with nothing pondered
+    for (int decisions = 0; decisions < 3 && !s.is_terminal();) {
+        Action a;
+        if (s.to_move == 0) {
+            a = bot.choose(s);
+            REQUIRE(s.is_legal(a));
+            if (waited) CHECK(bot.last_pondered() > 0);
+            waited = false;
+            ++decisions;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));  // the other seat thinks
+            a = other.choose(s);
+            waited = true;
+        }
+        s.apply(a);
+        bot.on_action(a, s);
+        CHECK(bot.pondering() == !s.is_terminal());
+    }
+    bot.stop_pondering();
+    CHECK_FALSE(bot.pondering());
+
+    // Through play_turn the other seats' actions reach the bot from the
+    // Game's history, and the next decision picks up the pondered subtree
+    Game g;
+    Governor governor(g, "Governor");
+    Spy spy(g, "Spy");
+    Baron baron(g, "Baron");
+    MctsBot table_bot(config);
+    std::streambuf* saved = std::cerr.rdbuf(nullptr);  // Spy::spy_on prints
+    waited = false;
+    int pondered_decisions = 0;
+    for (int turn = 0; turn < 12 && g.players().size() > 1 && pondered_decisions < 2; ++turn) {
+        if (g.turn() == "Governor") {
+            play_turn(table_bot, g);
+            uint64_t total = 0;
+            for (const auto& entry : table_bot.last_visits()) total += entry.second;
+            if (waited && table_bot.last_visits().size() > 1) {
+                CHECK(table_bot.last_pondered() > 0);
+                CHECK(total > static_cast<uint64_t>(config.iterations));  // kept from pondering
+                ++pondered_decisions;
+            }
+            waited = false;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            play_turn(other, g);
+            waited = true;
+        }
+    }
+    CHECK(pondered_decisions > 0);
+    std::cerr.rdbuf(saved);
+    table_bot.stop_pondering();
+
+    // Without ponder the bot never searches between decisions
+    config.ponder = false;
+    MctsBot idle(config);
+    GameState t = GameState::initial({Role::Governor, Role::Spy, Role::Baron});
+    idle.choose(t);
+    CHECK_FALSE(idle.pondering());
+}
+
+TEST_CASE("Work-stealing pool runs nested tasks and reports errors") {
+    WorkStealingPool pool(3);
+    std::atomic<int> sum{0};
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&pool, &sum, i] {
+            for (int j = 0; j < 10; ++j) pool.submit([&sum, i] { sum += i; });
+        });
+    }
+    pool.wait();
+    CHECK(sum == 10 * 4950);
+
+    pool.submit([] { throw std::runtime_error("boom"); });
+    CHECK_THROWS_AS(pool.wait(), std::runtime_error);
+    pool.submit([&sum] { ++sum; });
+    CHECK_NOTHROW(pool.wait());
+}
+
+TEST_CASE("Tournament rotates seats and rates the bots") {
+    std::vector<Entrant> entrants;
+    for (auto [name, params] : {std::pair{"greedy", HeuristicParams::greedy()},
+                                std::pair{"economic", HeuristicParams::economic()},
+                                std::pair{"aggressive", HeuristicParams::aggressive()}}) {
+        entrants.push_back({name, [params](uint64_t seed) {
+            return std::make_unique<HeuristicBot>("h", params, seed);
+        }});
+    }
+    static const UniformPolicy uniform;
+    entrants.push_back({"uniform", [](uint64_t seed) { return std::make_unique<PolicyBot>(uniform, seed); }});
+
+    TournamentConfig config;
+    config.seats = 3;
+    config.deals = 20;
+    config.threads = 1;  // same game order every run, so the same ratings
+    Tournament round_robin(entrants, config);
+    round_robin.run();
+    CHECK(round_robin.games_played() == 4 * 20 * 3);  // C(4,3) groups, every rotation
+    std::vector<Rating> table = round_robin.table();
+    double total = 0;
+    for (const Rating& r : table) {
+        CHECK(r.games == 3 * 20 * 3);  // in 3 of the 4 groups
+        CHECK(r.margin > 0);
+        total += r.elo;
+    }
+    CHECK(total == doctest::Approx(4 * 1500.0));  // pairwise updates are zero-sum
+    CHECK(table.front().name == "economic");
+
+    config.schedule = Schedule::Swiss;
+    config.rounds = 3;
+    config.threads = 3;
+    Tournament swiss(entrants, config);
+    swiss.run();
+    CHECK(swiss.games_played() == 3 * 2 * 20 * 3);  // rounds * groups * deals * rotations
+
+    // Deal ids stay distinct past 1024 deals per meeting: one replay per game
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "coup_test_deals";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    config.schedule = Schedule::RoundRobin;
+    config.seats = 2;
+    config.deals = 1100;
+    config.replay_dir = dir.string();
+    Tournament many(std::vector<Entrant>(entrants.begin(), entrants.begin() + 3), config);
+    many.run();
+    CHECK(many.games_played() == 3 * 1100 * 2);
+    size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) files += entry.is_regular_file();
+    CHECK(files == many.games_played());
+    std::filesystem::remove_all(dir);
+
+    config.deals = 0;
+    CHECK_THROWS_AS(Tournament(entrants, config), std::runtime_error);
+}
+
+TEST_CASE("Tuner evolves parameters and resumes from its checkpoint") {
+    HeuristicParams greedy = HeuristicParams::greedy();
+    HeuristicParams back = from_genes(to_genes(greedy));
+    CHECK(back.action_weight == greedy.action_weight);
+    CHECK(back.threat_bonus == greedy.threat_bonus);
+
+    std::string path = (std::filesystem::temp_directory_path() / "coup_test.ckpt").string();
+    std::filesystem::remove(path);
+    TunerConfig config;
+    config.population = 6;
+    config.elite = 2;
+    config.games = 60;
+    config.batch = 16;
+    config.threads = 2;
+    config.checkpoint = path;
+
+    Tuner tuner(config);
+    tuner.run(2);
+    CHECK(tuner.generation() == 2);
+    CHECK(tuner.best().fitness > 0);
+    CHECK(tuner.best().fitness <= 1);
+    // Common random numbers: the same parameters score the same on a generation's games
+    CHECK(tuner.fitness(greedy, 1) == tuner.fitness(greedy, 1));
+
+    Tuner resumed(config);
+    REQUIRE(resumed.generation() == 2);
+    tuner.run(1);
+    resumed.run(1);
+    std::filesystem::remove(path);
+    for (int i = 0; i < config.population; ++i) {
+        CHECK(resumed.population()[i].genes == tuner.population()[i].genes);
+        CHECK(resumed.population()[i].fitness == tuner.population()[i].fitness);
+    }
+}
+
+TEST_CASE("VecEnv steps games into caller buffers and deals again when they end") {
+    VecEnvConfig config;
+    config.num_envs = 8;
+    config.num_seats = 3;
+    VecEnv env(config);
+    std::vector<float> obs(8 * OBS_SIZE);
+    std::vector<uint8_t> masks(8 * NUM_ENV_ACTIONS);
+    std::vector<float> rewards(8 * MAX_PLAYERS);
+    std::vector<uint8_t> dones(8);
+    std::vector<int32_t> seats(8), actions(8);
+    EnvBuffers out{obs.data(), masks.data(), rewards.data(), dones.data(), seats.data()};
+    env.reset(out);
+
+    FastRng rng(2);
+    int finished = 0;
+    for (int step = 0; step < 600; ++step) {
+        for (int i = 0; i < 8; ++i) {
+            const GameState& s = env.state(i);
+            CHECK(seats[i] == s.to_move);
+            CHECK(obs[i * OBS_SIZE] == 1.0f);  // the mover is alive
+            CHECK(obs[i * OBS_SIZE + 1] == doctest::Approx(s.coins[s.to_move] / 10.0));
+            ActionList legal;
+            s.legal_actions(legal);
+            int count = 0;
+            for (int a = 0; a < NUM_ENV_ACTIONS; ++a) count += masks[i * NUM_ENV_ACTIONS + a];
+            REQUIRE(count == static_cast<int>(legal.size()));
+            Action pick = legal[rng.below(static_cast<uint32_t>(legal.size()))];
+            actions[i] = encode_action(s, pick);
+            CHECK(decode_action(s, actions[i]) == pick);
+        }
+        env.step(actions.data(), out);
+        for (int i = 0; i < 8; ++i) {
+            float total = 0;
+            for (int seat = 0; seat < MAX_PLAYERS; ++seat) total += rewards[i * MAX_PLAYERS + seat];
+            CHECK(total == doctest::Approx(dones[i] ? 1.0 : 0.0));
+            if (dones[i]) {
+                ++finished;
+                CHECK(env.state(i).ply == 0);
+            }
+        }
+    }
+    CHECK(finished > 0);
+
+    // A bad index is rejected before any game moves
+    const GameState before = env.state(0);
+    actions[0] = NUM_ENV_ACTIONS;
+    CHECK_THROWS_AS(env.step(actions.data(), out), std::runtime_error);
+    CHECK(env.state(0).hash() == before.hash());
+
+    // The C interface reports errors instead of throwing
+    coup_env* c = coup_env_create(4, 2, 400, 0, 7);
+    REQUIRE(c != nullptr);
+    CHECK(coup_env_create(4, 7, 400, 0, 7) == nullptr);
+    std::vector<uint8_t> c_masks(4 * coup_env_num_actions());
+    std::vector<int32_t> c_actions(4, -1);
+    CHECK(coup_env_reset(c, nullptr, c_masks.data(), nullptr) == 0);
+    CHECK(coup_env_step(c, c_actions.data(), nullptr, nullptr, nullptr, nullptr, nullptr) == -1);
+    CHECK(std::string(coup_env_last_error(c)).find("Illegal") != std::string::npos);
+    for (int i = 0; i < 4; ++i) {
+        c_actions[i] = static_cast<int32_t>(std::find(c_masks.begin() + i * NUM_ENV_ACTIONS,
+                                                      c_masks.begin() + (i + 1) * NUM_ENV_ACTIONS, 1)
+                                            - (c_masks.begin() + i * NUM_ENV_ACTIONS));
+    }
+    CHECK(coup_env_step(c, c_actions.data(), nullptr, c_masks.data(), nullptr, nullptr, nullptr) == 0);
+    coup_env_destroy(c);
+}
+
+TEST_CASE("Self-play ring hands records between processes with backpressure") {
+    const std::string name = "/coup_test_ring_" + std::to_string(getpid());
+    SelfPlayRing ring(name, 4);
+    SelfPlayRecord rec;
+    for (int i = 0; i < 4; ++i) {
+        rec.ply = static_cast<uint16_t>(i);
+        CHECK(ring.try_push(rec));
+    }
+    CHECK_FALSE(ring.try_push(rec));  // full until the learner reads
+    CHECK(ring.size() == 4);
+
+    SelfPlayRecord out[8];
+    REQUIRE(ring.pop_batch(out, 3) == 3);
+    CHECK(out[0].ply == 0);
+    CHECK(out[2].ply == 2);
+    CHECK(ring.pop_batch(out, 8) == 1);
+    CHECK(ring.pop_batch(out, 8) == 0);
+
+    // A child process pushes more than fits; push() waits for room
+    pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        int status = 0;
+        try {
+            SelfPlayRing actor(name);
+            for (uint32_t i = 0; i < 200; ++i) {
+                SelfPlayRecord r;
+                r.game = i;
+                r.outcome = 0.5f;
+                if (!actor.push(r)) status = 1;
+            }
+        } catch (...) {
+            status = 2;
+        }
+        _exit(status);
+    }
+    uint32_t next = 0;
+    bool in_order = true;
+    while (next < 200) {
+        size_t n = ring.pop_batch(out, 8);
+        for (size_t i = 0; i < n; ++i) in_order = in_order && out[i].game == next++ && out[i].outcome == 0.5f;
+        if (n == 0) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+    CHECK(in_order);
+    CHECK(ring.pushed() == 204);
+    CHECK(ring.stalls() > 0);
+
+    ring.close();
+    CHECK_FALSE(ring.push(rec));
+    CHECK_THROWS_AS(SelfPlayRing("/coup_test_no_such_ring"), std::runtime_error);
+}
+
+TEST_CASE("Replays stream actions in one or two bytes each") {
+    ReplayHeader header;
+    header.seed = 77;
+    header.roles = {Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge, Role::Merchant};
+    header.names = {"a", "b", "c", "d", "e", "f"};
+    GameState s = header.start();
+    FastRng rng(5);
+    std::vector<Action> moves;
+    std::stringstream file;
+    ReplayWriter writer(file, header);
+    const size_t header_size = file.str().size();
+    for (int ply = 0; ply < 400 && !s.is_terminal(); ++ply) {
+        Action a = rollout_action(s, RolloutPolicy::Random, rng);
+        s.apply(a);
+        moves.push_back(a);
+        writer.write(a);
+    }
+    writer.finish();
+    CHECK(writer.state().hash() == s.hash());
+    const size_t keyframes = (moves.size() + 63) / 64;
+    const size_t stream_size = file.str().size() - header_size - 2 - 8 - keyframes * 40 - 8 - REPLAY_FOOTER_SIZE;
+    CHECK(stream_size <= 2 * moves.size());
+    CHECK(stream_size < moves.size() * 5 / 4);
+
+    ReplayReader reader(file);
+    CHECK(reader.header().seed == 77);
+    CHECK(reader.header().names[5] == "f");
+    CHECK(reader.header().roles == header.roles);
+    Action a;
+    size_t i = 0;
+    GameState replayed = reader.header().start();
+    while (reader.next(a)) {
+        REQUIRE(i < moves.size());
+        CHECK(a == moves[i++]);
+        REQUIRE(replayed.is_legal(a));
+        replayed.apply(a);
+    }
+    CHECK(i == moves.size());
+    CHECK(reader.footer().actions == moves.size());
+    CHECK(reader.footer().final_hash == replayed.hash());
+
+    std::string bytes = file.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 5));
+    ReplayReader short_reader(truncated);
+    CHECK_THROWS_AS(while (short_reader.next(a)) {}, std::runtime_error);
+    std::stringstream garbage("COUPRPLX");
+    CHECK_THROWS_AS(ReplayReader{garbage}, std::runtime_error);
+}
+
+TEST_CASE("Mapped replays seek through keyframes") {
+    ReplayHeader header;
+    header.roles = {Role::Spy, Role::Baron, Role::General, Role::Merchant};
+    std::vector<GameState> states{header.start()};
+    std::vector<Action> moves;
+    FastRng rng(8);
+    GameState s = header.start();
+    for (int ply = 0; ply < 400 && !s.is_terminal(); ++ply) {
+        Action a = rollout_action(s, RolloutPolicy::Random, rng);
+        s.apply(a);
+        moves.push_back(a);
+        states.push_back(s);
+    }
+    REQUIRE(moves.size() > 20);
+    std::string path = (std::filesystem::temp_directory_path() / "coup_test.replay").string();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        ReplayWriter writer(out, header, 8);
+        for (const Action& a : moves) writer.write(a);
+        writer.finish();
+    }
+
+    ReplayFile file(path);
+    CHECK(file.keyframe_interval() == 8);
+    CHECK(file.footer().actions == moves.size());
+    CHECK(file.footer().final_hash == s.hash());
+    for (uint64_t n : {uint64_t{0}, uint64_t{7}, uint64_t{8}, uint64_t{13}, uint64_t{moves.size()}}) {
+        ReplayCursor c = file.seek(n);
+        CHECK(c.index() == n);
+        CHECK(c.state().hash() == states[n].hash());
+        CHECK(c.state().ply == states[n].ply);
+    }
+    ReplayCursor c = file.seek(5);
+    Action a;
+    for (size_t i = 5; i < moves.size(); ++i) {
+        REQUIRE(c.next(a));
+        CHECK(a == moves[i]);
+    }
+    CHECK_FALSE(c.next(a));
+    CHECK(c.state().hash() == s.hash());
+    CHECK_THROWS_AS(file.seek(moves.size() + 1), std::runtime_error);
+
+    // The stream reader skips the keyframes
+    std::ifstream in(path, std::ios::binary);
+    ReplayReader reader(in);
+    size_t count = 0;
+    while (reader.next(a)) ++count;
+    CHECK(count == moves.size());
+    CHECK(reader.footer().final_hash == s.hash());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Game::apply_batch matches the Player API action for action") {
+    std::streambuf* saved = std::cerr.rdbuf(nullptr);  // Spy::spy_on prints
+    FastRng rng(21);
+    for (int g = 0; g < 40; ++g) {
+        const int n = 2 + g % 5;
+        std::vector<Role> roles(n);
+        for (Role& r : roles) r = static_cast<Role>(rng.below(NUM_ROLES));
+        Game slow, fast;
+        std::vector<std::unique_ptr<Player>> owned;
+        std::vector<Player*> slow_seats, fast_seats;
+        for (int i = 0; i < n; ++i) {
+            owned.emplace_back(create_player(slow, roles[i], "p" + std::to_string(i)));
+            slow_seats.push_back(owned.back().get());
+            owned.emplace_back(create_player(fast, roles[i], "p" + std::to_string(i)));
+            fast_seats.push_back(owned.back().get());
+        }
+        GameState s = GameState::initial(roles);
+        std::vector<Action> moves;
+        for (int ply = 0; ply < 300 && !s.is_terminal(); ++ply) {
+            Action a = rollout_action(s, RolloutPolicy::Random, rng);
+            s.apply(a);
+            perform(a, slow_seats);
+            moves.push_back(a);
+        }
+        // In uneven chunks, so batches start mid-turn
+        for (size_t i = 0; i < moves.size(); i += 1 + i % 7) {
+            size_t len = std::min<size_t>(1 + i % 7, moves.size() - i);
+            fast.apply_batch(std::span<const Action>(moves).subspan(i, len));
+        }
+        CHECK(fast.seats() == fast_seats);
+        GameState a = state_from_players(slow, slow_seats);
+        GameState b = state_from_players(fast, fast.seats());
+        CHECK(b.hash() == a.hash());
+        CHECK(b.hash() == s.hash());
+        CHECK(fast.players() == slow.players());
+        CHECK(slow.history() == moves);
+        CHECK(fast.history() == moves);
+    }
+    std::cerr.rdbuf(saved);
+
+    Game game;
+    Governor gov(game, "gov");
+    Spy spy(game, "spy");
+    Action out_of_turn{ActionType::Gather, 1, NO_SEAT};
+    CHECK_THROWS_AS(game.apply_batch(std::span<const Action>(&out_of_turn, 1)), std::runtime_error);
+    Action gather{ActionType::Gather, 0, NO_SEAT};
+    game.apply_batch(std::span<const Action>(&gather, 1));
+    CHECK(gov.coins() == 1);
+    CHECK(game.turn() == "spy");
+}
+
+TEST_CASE("Replay corpus verifier re-simulates a directory in parallel") {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "coup_test_corpus";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "archive");
+
+    std::vector<Entrant> entrants;
+    entrants.push_back({"greedy", [](uint64_t seed) {
+        return std::make_unique<HeuristicBot>("h", HeuristicParams::greedy(), seed);
+    }});
+    entrants.push_back({"economic", [](uint64_t seed) {
+        return std::make_unique<HeuristicBot>("h", HeuristicParams::economic(), seed);
+    }});
+    TournamentConfig config;
+    config.deals = 10;
+    config.threads = 2;
+    config.replay_dir = (dir / "archive").string();
+    Tournament tournament(entrants, config);
+    tournament.run();
+    std::ofstream(dir / "notes.txt") << "not a replay";
+
+    CorpusConfig verify;
+    verify.threads = 4;
+    verify.batch = 3;
+    CorpusReport clean = verify_corpus(dir.string(), verify);
+    CHECK(clean.files == tournament.games_played());
+    CHECK(clean.actions > clean.files);
+    CHECK(clean.ok());
+    CHECK(clean.problems.empty());
+
+    // A wrong final hash is a mismatch; a cut-off file and a bad keyframe are errors
+    auto flip = [](const fs::path& path, std::streamoff from_end) {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekg(from_end, std::ios::end);
+        char c = static_cast<char>(f.get() ^ 1);
+        f.seekp(from_end, std::ios::end);
+        f.put(c);
+    };
+    flip(dir / "archive" / "0_0.replay", -static_cast<std::streamoff>(REPLAY_FOOTER_SIZE - 8));
+    fs::resize_file(dir / "archive" / "1_0.replay", fs::file_size(dir / "archive" / "1_0.replay") - 30);
+    flip(dir / "archive" / "2_1.replay", -static_cast<std::streamoff>(REPLAY_FOOTER_SIZE + 8 + 1));  // in the last keyframe
+
+    CorpusReport bad = verify_corpus(dir.string(), verify);
+    CHECK(bad.files == clean.files);
+    CHECK(bad.mismatches == 1);
+    CHECK(bad.errors == 2);
+    REQUIRE(bad.problems.size() == 3);
+    CHECK(bad.problems[0].path.find("0_0.replay") != std::string::npos);
+    CHECK(bad.problems[1].path.find("1_0.replay") != std::string::npos);
+    CHECK(bad.problems[2].path.find("2_1.replay") != std::string::npos);
+    CHECK_THROWS_AS(verify_corpus((dir / "notes.txt").string()), std::runtime_error);
+    fs::remove_all(dir);
+}
@@ -0,0 +1,486 @@
+// Email: adhamhamoudy3@gmail.com
+// Throughput benchmarks for the engine and the bots.
+
+#include "BeliefTracker.hpp"
+#include "Game.hpp"
+#include "GameBridge.hpp"
+#include "HeuristicBot.hpp"
+#include "IsmctsBot.hpp"
+#include "MctsBot.hpp"
+#include "Player.hpp"
+#include "Replay.hpp"
+#include "VecEnv.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace coup;
+
+static GameState six_player_start() {
+    return GameState::initial({Role::Governor, Role::Spy, Role::Baron,
+                               Role::General, Role::Judge, Role::Merchant});
+}
+
+// Playouts/sec of one decision for root and tree parallelization, doubling
+// the thread count up to max_threads.
+static void bench_mcts(unsigned max_threads, int time_ms) {
+    GameState start = six_player_start();
+    cout << "mode  threads  playouts/sec" << endl;
+    for (Parallelism mode : {Parallelism::Root, Parallelism::Tree}) {
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            MctsConfig config;
+            config.iterations = 0;
+            config.time_ms = time_ms;
+            config.threads = threads;
+            config.parallelism = mode;
+            config.max_nodes = 1 << 22;
+            config.seed = 1;
+            MctsBot bot(config);
+
+            auto begin = chrono::steady_clock::now();
+            bot.choose(start);
+            double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            cout << (mode == Parallelism::Root ? "root  " : "tree  ") << threads << "\t "
+                 << static_cast<uint64_t>(bot.last_playouts() / secs) << endl;
+        }
+    }
+}
+
+// Same for information-set MCTS, which pays for a determinization every
+// iteration; compare with the root rows of `mcts`.
+static void bench_ismcts(unsigned max_threads, int time_ms) {
+    GameState start = six_player_start();
+    cout << "threads  playouts/sec" << endl;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        MctsConfig config;
+        config.iterations = 0;
+        config.time_ms = time_ms;
+        config.threads = threads;
+        config.seed = 1;
+        IsmctsBot bot(config);
+        bot.on_game_start(start, 0);
+
+        auto begin = chrono::steady_clock::now();
+        bot.choose(start);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        cout << threads << "\t " << static_cast<uint64_t>(bot.last_playouts() / secs) << endl;
+    }
+}
+
+static volatile uint64_t sink;
+
+// Nanoseconds per decision of each heuristic preset, over positions taken
+// from random six-player games.
+static void bench_heuristic(int positions) {
+    vector<GameState> states;
+    FastRng rng(1);
+    while (static_cast<int>(states.size()) < positions) {
+        GameState s = six_player_start();
+        for (int ply = 0; ply < 200 && !s.is_terminal(); ++ply) {
+            states.push_back(s);
+            s.apply(rollout_action(s, RolloutPolicy::Random, rng));
+        }
+    }
+    const pair<const char*, HeuristicParams> presets[] = {
+        {"greedy", HeuristicParams::greedy()},
+        {"economic", HeuristicParams::economic()},
+        {"aggressive", HeuristicParams::aggressive()},
+    };
+    cout << "bot         ns/decision" << endl;
+    for (const auto& [name, params] : presets) {
+        uint64_t checksum = 0;
+        auto begin = chrono::steady_clock::now();
+        for (int round = 0; round < 10; ++round) {
+            for (const GameState& s : states) checksum += static_cast<int>(heuristic_action(s, params, rng).type);
+        }
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        sink = checksum;  // keep the decisions from being optimized away
+        cout << name << "\t    " << secs * 1e9 / (10.0 * static_cast<double>(states.size())) << endl;
+    }
+}
+
+// Cost of one BeliefTracker update, and how often its likeliest role for
+// a living opponent is the true one at the end of a heuristic game.
+static void bench_belief(int games) {
+    FastRng rng(1);
+    HeuristicParams params = HeuristicParams::economic();
+    params.epsilon = 0.1f;
+    uint64_t events = 0, guesses = 0, right = 0;
+    double secs = 0;
+    for (int g = 0; g < games; ++g) {
+        vector<Role> roles(MAX_PLAYERS);
+        for (Role& r : roles) r = static_cast<Role>(rng.below(NUM_ROLES));
+        GameState s = GameState::initial(roles);
+        BeliefTracker tracker(s, 0);
+        for (int ply = 0; ply < 400 && !s.is_terminal(); ++ply) {
+            Action a = heuristic_action(s, params, rng);
+            s.apply(a);
+            auto begin = chrono::steady_clock::now();
+            tracker.observe(a, s);
+            secs += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            ++events;
+        }
+        for (int seat = 1; seat < s.num_seats; ++seat) {
+            if (!s.is_alive(seat)) continue;
+            ++guesses;
+            if (tracker.likely_role(seat) == s.roles[seat]) ++right;
+        }
+    }
+    cout << "ns/event  likeliest role right" << endl;
+    cout << secs * 1e9 / static_cast<double>(events ? events : 1) << "\t  "
+         << 100.0 * static_cast<double>(right) / static_cast<double>(guesses ? guesses : 1) << "%" << endl;
+}
+
+// VecEnv::step() throughput. Actions are drawn from the masks outside the
+// timed part, as a trainer's policy would be.
+static void bench_env(int num_envs, int steps) {
+    cout << "seats  env-steps/sec" << endl;
+    for (int seats : {2, 6}) {
+        VecEnvConfig config;
+        config.num_envs = num_envs;
+        config.num_seats = seats;
+        VecEnv env(config);
+        vector<float> obs(static_cast<size_t>(num_envs) * OBS_SIZE);
+        vector<uint8_t> masks(static_cast<size_t>(num_envs) * NUM_ENV_ACTIONS);
+        vector<float> rewards(static_cast<size_t>(num_envs) * MAX_PLAYERS);
+        vector<uint8_t> dones(num_envs);
+        vector<int32_t> seat(num_envs), actions(num_envs);
+        EnvBuffers out{obs.data(), masks.data(), rewards.data(), dones.data(), seat.data()};
+        env.reset(out);
+        FastRng rng(1);
+        double secs = 0;
+        for (int k = 0; k < steps; ++k) {
+            for (int i = 0; i < num_envs; ++i) {
+                const uint8_t* m = &masks[static_cast<size_t>(i) * NUM_ENV_ACTIONS];
+                int legal[NUM_ENV_ACTIONS], count = 0;
+                for (int a = 0; a < NUM_ENV_ACTIONS; ++a) {
+                    if (m[a]) legal[count++] = a;
+                }
+                actions[i] = legal[rng.below(count)];
+            }
+            auto begin = chrono::steady_clock::now();
+            env.step(actions.data(), out);
+            secs += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        }
+        cout << seats << "\t" << static_cast<uint64_t>(static_cast<double>(num_envs) * steps / secs) << endl;
+    }
+}
+
+// Random seeks into one long mapped replay, with and without keyframes.
+static void bench_seek(int seeks) {
+    ReplayHeader header;
+    header.roles = {Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge, Role::Merchant};
+    FastRng rng(1);
+    vector<Action> moves;
+    while (moves.size() < 300) {  // keep the longest of a few random games
+        vector<Action> game;
+        GameState s = header.start();
+        for (int ply = 0; ply < 2000 && !s.is_terminal(); ++ply) {
+            game.push_back(rollout_action(s, RolloutPolicy::Random, rng));
+            s.apply(game.back());
+        }
+        if (game.size() > moves.size()) moves = game;
+    }
+    const string path = (filesystem::temp_directory_path() / "coup_bench.replay").string();
+    cout << moves.size() << " actions" << endl << "interval  ns/seek" << endl;
+    for (uint32_t interval : {0u, 64u, 16u}) {
+        {
+            ofstream out(path, ios::binary | ios::trunc);
+            ReplayWriter writer(out, header, interval);
+            for (const Action& a : moves) writer.write(a);
+            writer.finish();
+        }
+        ReplayFile file(path);
+        uint64_t checksum = 0;
+        auto begin = chrono::steady_clock::now();
+        for (int i = 0; i < seeks; ++i) {
+            checksum += file.seek(rng.below(static_cast<uint32_t>(moves.size() + 1))).state().hash();
+        }
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        sink = checksum;
+        cout << (interval ? to_string(interval) : string("none")) << "\t  " << secs * 1e9 / seeks << endl;
+    }
+    filesystem::remove(path);
+}
+
+// Actions/sec replaying recorded games onto the Player classes, one
+// perform() per action against one apply_batch() per game.
+static void bench_apply(int games) {
+    const vector<Role> roles = {Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge, Role::Merchant};
+    FastRng rng(3);
+    vector<vector<Action>> recorded(games);
+    uint64_t total = 0;
+    for (vector<Action>& moves : recorded) {
+        GameState s = GameState::initial(roles);
+        for (int ply = 0; ply < 2000 && !s.is_terminal(); ++ply) {
+            moves.push_back(rollout_action(s, RolloutPolicy::Random, rng));
+            s.apply(moves.back());
+        }
+        total += moves.size();
+    }
+    streambuf* cerr_buf = cerr.rdbuf(nullptr);  // Spy::spy_on prints
+    cout << total << " actions" << endl << "mode     actions/sec" << endl;
+    for (bool batched : {false, true}) {
+        double secs = 0;
+        uint64_t checksum = 0;
+        for (const vector<Action>& moves : recorded) {
+            Game game;
+            vector<unique_ptr<Player>> owned;
+            vector<Player*> seats;
+            for (size_t i = 0; i < roles.size(); ++i) {
+                owned.emplace_back(create_player(game, roles[i], "P" + to_string(i)));
+                seats.push_back(owned.back().get());
+            }
+            auto begin = chrono::steady_clock::now();
+            if (batched) {
+                game.apply_batch(span<const Action>(moves));
+            } else {
+                for (const Action& a : moves) perform(a, seats);
+            }
+            secs += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            checksum += static_cast<uint64_t>(seats[0]->coins());
+        }
+        sink = checksum;
+        cout << (batched ? "batch  " : "perform") << "  " << static_cast<uint64_t>(static_cast<double>(total) / secs) << endl;
+    }
+    cerr.rdbuf(cerr_buf);
+}
+
+// Plays one game on the fast engine; returns the winner's seat, or -1 if
+// it runs past max_plies.
+static int play_game(GameState state, Bot* seats[], int max_plies) {
+    for (int ply = 0; ply < max_plies && !state.is_terminal(); ++ply) {
+        state.apply(seats[state.to_move]->choose(state));
+    }
+    return state.winner();
+}
+
+// Playouts/sec and games won against a reference bot (same playouts, no
+// node cap, no tree reuse) at a range of node budgets.
+static void bench_memory(int iterations, int games) {
+    cout << "max_nodes  reuse  playouts/sec  wins/" << games << endl;
+    for (size_t budget : {size_t(1) << 10, size_t(1) << 12, size_t(1) << 14, size_t(1) << 20}) {
+        for (bool reuse : {false, true}) {
+            uint64_t playouts = 0;
+            double secs = 0;
+            int wins = 0;
+            for (int g = 0; g < games; ++g) {
+                MctsConfig config;
+                config.iterations = iterations;
+                config.seed = 100 + g;
+                MctsBot reference(config);
+                config.max_nodes = budget;
+                config.reuse_tree = reuse;
+                MctsBot bounded(config);
+
+                // Alternate seats so neither bot always moves first
+                int seat = g % 2;
+                Bot* seats[2];
+                seats[seat] = &bounded;
+                seats[1 - seat] = &reference;
+                GameState start = GameState::initial({Role::Governor, Role::Baron});
+                if (play_game(start, seats, 400) == seat) ++wins;
+
+                // Throughput of the bounded bot alone, from the opening
+                auto begin = chrono::steady_clock::now();
+                bounded.choose(six_player_start());
+                secs += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+                playouts += bounded.last_playouts();
+            }
+            cout << budget << "\t   " << (reuse ? "yes" : "no ") << "    "
+                 << static_cast<uint64_t>(playouts / secs) << "\t  " << wins << endl;
+        }
+    }
+}
+
+// Decision latency and strength of MCTS scoring leaves with the linear
+// evaluator (trained here on `train_games` self-play games) against the
+// same search with rollouts, at equal iteration budgets.
+static void bench_eval(int train_games, int games) {
+    EvalTrainConfig train;
+    train.games = train_games;
+    train.threads = thread::hardware_concurrency();
+    LinearEvaluator eval = train_evaluator(train);
+
+    cout << "iterations  rollout ms  eval ms  eval wins/" << games << endl;
+    for (int iterations : {1000, 4000, 16000}) {
+        double secs[2] = {0, 0};
+        int wins = 0;
+        for (int g = 0; g < games; ++g) {
+            MctsConfig config;
+            config.iterations = iterations;
+            config.endgame_depth = 0;
+            config.seed = 100 + g;
+            MctsBot with_rollouts(config);
+            config.evaluator = &eval;
+            MctsBot with_eval(config);
+
+            int seat = g % 2;
+            Bot* seats[2];
+            seats[seat] = &with_eval;
+            seats[1 - seat] = &with_rollouts;
+            GameState start = GameState::initial({Role::Governor, Role::Baron});
+            if (play_game(start, seats, 400) == seat) ++wins;
+
+            MctsBot* bots[2] = {&with_rollouts, &with_eval};
+            for (int b = 0; b < 2; ++b) {
+                auto begin = chrono::steady_clock::now();
+                bots[b]->choose(six_player_start());
+                secs[b] += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            }
+        }
+        cout << iterations << "\t    " << secs[0] * 1000 / games << "\t" << secs[1] * 1000 / games
+             << "\t  " << wins << endl;
+    }
+}
+
+// Time per decide() call with a fixed deadline, over positions from random
+// six-player games: median and worst case, per search.
+static void bench_latency(int deadline_ms, int decisions) {
+    vector<GameState> states;
+    FastRng rng(1);
+    while (static_cast<int>(states.size()) < decisions) {
+        GameState s = six_player_start();
+        for (int ply = rng.below(40); ply > 0 && !s.is_terminal(); --ply) {
+            s.apply(rollout_action(s, RolloutPolicy::Heuristic, rng));
+        }
+        if (!s.is_terminal()) states.push_back(s);
+    }
+    MctsConfig config;
+    config.iterations = 0;
+    config.threads = thread::hardware_concurrency();
+    config.seed = 1;
+    MctsBot root(config);
+    config.parallelism = Parallelism::Tree;
+    MctsBot tree(config);
+    IsmctsBot ismcts(config);
+    const pair<const char*, Bot*> bots[] = {{"mcts root", &root}, {"mcts tree", &tree}, {"ismcts", &ismcts}};
+
+    cout << "bot         deadline ms  median ms  worst ms" << endl;
+    for (const auto& [name, bot] : bots) {
+        vector<double> ms;
+        for (const GameState& s : states) {
+            auto begin = chrono::steady_clock::now();
+            bot->decide(s, Deadline::after(chrono::milliseconds(deadline_ms)));
+            ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count());
+        }
+        sort(ms.begin(), ms.end());
+        cout << name << "\t    " << deadline_ms << "\t\t " << ms[ms.size() / 2] << "\t    " << ms.back() << endl;
+    }
+}
+
+// Root visits behind each decision and games won at a six-seat table, by
+// an MCTS bot with and without pondering against five heuristic bots that
+// take think_ms per move. Same seeds for both.
+static void bench_ponder(int iterations, int games, int think_ms) {
+    cout << "ponder  root visits/decision  wins/" << games << endl;
+    for (bool ponder : {false, true}) {
+        uint64_t root_visits = 0;
+        uint64_t decisions = 0;
+        int wins = 0;
+        for (int g = 0; g < games; ++g) {
+            MctsConfig config;
+            config.iterations = iterations;
+            config.seed = 100 + g;
+            config.ponder = ponder;
+            MctsBot bot(config);
+            vector<HeuristicBot> others;
+            for (int i = 1; i < MAX_PLAYERS; ++i) others.emplace_back("h", HeuristicParams::economic(), g * 10 + i);
+
+            GameState s = six_player_start();
+            bot.on_game_start(s, 0);
+            for (int ply = 0; ply < 400 && !s.is_terminal(); ++ply) {
+                Action a;
+                if (s.to_move == 0) {
+                    a = bot.choose(s);
+                    for (const auto& entry : bot.last_visits()) root_visits += entry.second;
+                    ++decisions;
+                } else {
+                    this_thread::sleep_for(chrono::milliseconds(think_ms));
+                    a = others[s.to_move - 1].choose(s);
+                }
+                s.apply(a);
+                bot.on_action(a, s);
+            }
+            if (s.winner() == 0) ++wins;
+        }
+        cout << (ponder ? "yes" : "no ") << "\t" << (decisions ? root_visits / decisions : 0) << "\t\t\t  " << wins << endl;
+    }
+}
+
+// Usage: bench_exec mcts|ismcts [max_threads] [time_ms]
+//        bench_exec memory [iterations] [games]
+//        bench_exec heuristic [positions]
+//        bench_exec eval [train_games] [games]
+//        bench_exec belief [games]
+//        bench_exec env [num_envs] [steps]
+//        bench_exec seek [seeks]
+//        bench_exec apply [games]
+//        bench_exec latency [deadline_ms] [decisions]
+//        bench_exec ponder [iterations] [games] [think_ms]
+int main(int argc, char** argv) {
+    string what = argc > 1 ? argv[1] : "mcts";
+    if (what == "heuristic") {
+        bench_heuristic(argc > 2 ? atoi(argv[2]) : 100000);
+        return 0;
+    }
+    if (what == "seek") {
+        bench_seek(argc > 2 ? atoi(argv[2]) : 100000);
+        return 0;
+    }
+    if (what == "apply") {
+        bench_apply(argc > 2 ? atoi(argv[2]) : 2000);
+        return 0;
+    }
+    if (what == "env") {
+        bench_env(argc > 2 ? atoi(argv[2]) : 1024, argc > 3 ? atoi(argv[3]) : 2000);
+        return 0;
+    }
+    if (what == "belief") {
+        bench_belief(argc > 2 ? atoi(argv[2]) : 2000);
+        return 0;
+    }
+    if (what == "ponder") {
+        bench_ponder(argc > 2 ? atoi(argv[2]) : 2000, argc > 3 ? atoi(argv[3]) : 10, argc > 4 ? atoi(argv[4]) : 10);
+        return 0;
+    }
+    if (what == "latency") {
+        bench_latency(argc > 2 ? atoi(argv[2]) : 50, argc > 3 ? atoi(argv[3]) : 100);
+        return 0;
+    }
+    if (what == "eval") {
+        int train_games = argc > 2 ? atoi(argv[2]) : 2000;
+        int games = argc > 3 ? atoi(argv[3]) : 10;
+        bench_eval(train_games, games);
+        return 0;
+    }
+    if (what == "memory") {
+        int iterations = argc > 2 ? atoi(argv[2]) : 5000;
+        int games = argc > 3 ? atoi(argv[3]) : 20;
+        bench_memory(iterations, games);
+        return 0;
+    }
+    if (what == "mcts" || what == "ismcts") {
+        unsigned max_threads = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : thread::hardware_concurrency();
+        int time_ms = argc > 3 ? atoi(argv[3]) : 1000;
+        if (what == "mcts") {
+            bench_mcts(max_threads ? max_threads : 1, time_ms);
+        } else {
+            bench_ismcts(max_threads ? max_threads : 1, time_ms);
+        }
+        return 0;
+    }
+    cerr << "Unknown benchmark: " << what << endl;
+    return 2;
+}
@@ -0,0 +1,39 @@
+// Email: adhamhamoudy3@gmail.com
+// Builds the opening book that MctsBot plays from (MctsConfig::book).
+
+#include "OpeningBook.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace coup;
+
+// Usage: book_exec <file> [threads] [seats] [plies] [iterations]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <file> [threads] [seats] [plies] [iterations]" << endl;
+        return 2;
+    }
+    try {
+        OpeningBookConfig config;
+        config.threads = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : thread::hardware_concurrency();
+        if (argc > 3) config.num_seats = atoi(argv[3]);
+        if (argc > 4) config.plies = atoi(argv[4]);
+        if (argc > 5) config.iterations = atoi(argv[5]);
+
+        auto begin = chrono::steady_clock::now();
+        uint64_t entries = build_opening_book(argv[1], config, &cout);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        OpeningBook book(argv[1]);
+        cout << entries << " positions (" << book.plies() << " plies) in " << secs << " s" << endl;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+// Email: adhamhamoudy3@gmail.com
+// Trains the two-player CFR policy and saves it for PolicyBot/CfrPolicy.
+
+#include "Cfr.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace coup;
+
+// Usage: cfr_exec <iterations> [threads] [out_file] [report_every]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <iterations> [threads] [out_file] [report_every]" << endl;
+        return 2;
+    }
+    try {
+        uint64_t iterations = strtoull(argv[1], nullptr, 10);
+        CfrConfig config;
+        config.threads = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : thread::hardware_concurrency();
+        string out = argc > 3 ? argv[3] : "cfr.policy";
+        uint64_t report_every = argc > 4 ? strtoull(argv[4], nullptr, 10) : iterations / 10;
+
+        CfrSolver solver(config);
+        auto begin = chrono::steady_clock::now();
+        solver.run(iterations, &cout, report_every);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        solver.policy().save(out);
+        cout << solver.iterations() << " iterations in " << secs << " s ("
+             << static_cast<uint64_t>(solver.iterations() / secs) << "/sec), regret bound "
+             << solver.regret_bound() << ", saved " << out << endl;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    return 0;
+}
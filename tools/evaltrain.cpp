@@ -0,0 +1,41 @@
+// Email: adhamhamoudy3@gmail.com
+// Trains the linear evaluator by self-play and saves it for MctsConfig::evaluator.
+
+#include "Evaluator.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace coup;
+
+// Usage: evaltrain_exec <games> [threads] [out_file] [epochs]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <games> [threads] [out_file] [epochs]" << endl;
+        return 2;
+    }
+    try {
+        EvalTrainConfig config;
+        config.games = atoi(argv[1]);
+        config.threads = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : thread::hardware_concurrency();
+        string out = argc > 3 ? argv[3] : "coup.eval";
+        if (argc > 4) config.epochs = atoi(argv[4]);
+
+        auto begin = chrono::steady_clock::now();
+        LinearEvaluator eval = train_evaluator(config, &cout);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        eval.save(out);
+        cout << "weights:";
+        for (float w : eval.weights) cout << ' ' << w;
+        cout << "\ntrained in " << secs << " s, saved " << out << endl;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    return 0;
+}
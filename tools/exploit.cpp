@@ -0,0 +1,52 @@
+// Email: adhamhamoudy3@gmail.com
+// Ranks a policy by its exploitability: what a best response wins against
+// it in two-player games.
+
+#include "BestResponse.hpp"
+#include "Cfr.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace coup;
+
+// Usage: exploit_exec <uniform|cfr_policy_file> [depth] [threads] [tablebase]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <uniform|cfr_policy_file> [depth] [threads] [tablebase]" << endl;
+        return 2;
+    }
+    try {
+        string name = argv[1];
+        unique_ptr<Policy> policy;
+        if (name == "uniform") {
+            policy = make_unique<UniformPolicy>();
+        } else {
+            policy = make_unique<CfrPolicy>(name);
+        }
+        BestResponseConfig config;
+        config.depth = argc > 2 ? atoi(argv[2]) : 8;
+        config.threads = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : thread::hardware_concurrency();
+        unique_ptr<Tablebase> table;
+        if (argc > 4) {
+            table = make_unique<Tablebase>(argv[4]);
+            config.tablebase = table.get();
+        }
+
+        auto begin = chrono::steady_clock::now();
+        ExploitabilityResult r = exploitability(*policy, config);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        cout << name << ": exploitability " << r.value << " (first seat " << r.by_seat[0]
+             << ", second seat " << r.by_seat[1] << ") at depth " << config.depth << "\n"
+             << r.nodes << " nodes in " << secs << " s" << endl;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    return 0;
+}
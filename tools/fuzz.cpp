@@ -0,0 +1,96 @@
+// Email: adhamhamoudy3@gmail.com
+// Fuzz target for Game/Player. Built with clang's -fsanitize=fuzzer and
+// -DCOUP_LIBFUZZER it is a plain libFuzzer target; otherwise it carries its
+// own driver that replays crash files or runs a random in-process campaign.
+
+#include "Fuzz.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    coup::fuzz_one_input(data, size);  // InvariantViolation escapes and aborts
+    return 0;
+}
+
+#ifndef COUP_LIBFUZZER
+
+using namespace std;
+
+static void save_crash(const vector<uint8_t>& input) {
+    ofstream out("crash-input", ios::binary);
+    out.write(reinterpret_cast<const char*>(input.data()), input.size());
+    cerr << "Input written to ./crash-input" << endl;
+}
+
+static int replay_file(const char* path) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        cerr << "Cannot open " << path << endl;
+        return 2;
+    }
+    vector<uint8_t> input((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    try {
+        coup::fuzz_one_input(input.data(), input.size());
+    } catch (const coup::InvariantViolation& e) {
+        cerr << path << ": " << e.what() << endl;
+        return 1;
+    }
+    cout << path << ": ok" << endl;
+    return 0;
+}
+
+// Usage: fuzz_exec [iterations] [seed]   or   fuzz_exec <crash-file>...
+int main(int argc, char** argv) {
+    if (argc > 1 && !isdigit(static_cast<unsigned char>(argv[1][0]))) {
+        int status = 0;
+        for (int i = 1; i < argc; ++i) status |= replay_file(argv[i]);
+        return status;
+    }
+
+    long iterations = argc > 1 ? atol(argv[1]) : 200000;
+    unsigned seed = argc > 2 ? static_cast<unsigned>(atol(argv[2])) : random_device{}();
+    mt19937_64 rng(seed);
+    vector<uint8_t> input;
+
+    // Spy::spy_on logs to std::cerr; keep it quiet during the campaign
+    streambuf* cerr_buf = cerr.rdbuf(nullptr);
+
+    auto start = chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        input.resize(2 + rng() % 64);
+        for (auto& b : input) b = static_cast<uint8_t>(rng());
+        try {
+            coup::fuzz_one_input(input.data(), input.size());
+        } catch (const coup::InvariantViolation& e) {
+            cerr.rdbuf(cerr_buf);
+            cerr.clear();
+            cerr << "Invariant violated (seed " << seed << ", iteration " << i << "): "
+                 << e.what() << endl;
+            save_crash(input);
+            return 1;
+        }
+    }
+    cerr.rdbuf(cerr_buf);
+    cerr.clear();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << iterations << " inputs in " << secs << " s (" << static_cast<long>(iterations / secs)
+         << " execs/sec), seed " << seed << endl;
+    const uint64_t abandoned = coup::abandoned_playouts();
+    cout << abandoned << " play-outs abandoned to blocked coups" << endl;
+    if (abandoned * 100 > static_cast<uint64_t>(iterations) * coup::MAX_ABANDONED_PERCENT) {
+        cerr << "More than " << coup::MAX_ABANDONED_PERCENT << "% of play-outs never ended (seed " << seed << ")"
+             << endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif
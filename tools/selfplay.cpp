@@ -0,0 +1,134 @@
+// Email: adhamhamoudy3@gmail.com
+// Self-play data pipeline: actor processes play MctsBot games and push one
+// record per decision into a shared-memory ring; this process is the
+// learner and drains it in batches. A learner slower than the actors
+// (learner_ms per batch) makes them wait on the full ring.
+//
+// Usage: selfplay_exec [actors] [seconds] [iterations] [seats] [learner_ms] [batch]
+
+#include "MctsBot.hpp"
+#include "SelfPlayRing.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace coup;
+
+// Plays games until the learner closes the ring. Records of a game are
+// held until its end, when the outcome is known.
+static void run_actor(const string& name, uint32_t id, int iterations, int seats) {
+    SelfPlayRing ring(name);
+    FastRng rng(0x5e1f0000ULL + id);
+    for (uint32_t game = 0;; ++game) {
+        vector<Role> roles(seats);
+        for (Role& r : roles) r = static_cast<Role>(rng.below(NUM_ROLES));
+        GameState s = GameState::initial(roles);
+        MctsConfig config;
+        config.iterations = iterations;
+        config.seed = rng.next() | 1;
+        MctsBot bot(config);
+
+        vector<SelfPlayRecord> records;
+        for (int ply = 0; ply < 400 && !s.is_terminal(); ++ply) {
+            SelfPlayRecord rec;
+            write_observation(s, false, rec.obs);
+            fill(begin(rec.policy), end(rec.policy), 0.0f);
+            const Action a = bot.choose(s);
+            uint64_t total = 0;
+            for (const auto& entry : bot.last_visits()) total += entry.second;
+            for (const auto& entry : bot.last_visits()) {
+                if (total) rec.policy[encode_action(s, entry.first)] = static_cast<float>(entry.second) / total;
+            }
+            if (!total) rec.policy[encode_action(s, a)] = 1;
+            rec.actor = id;
+            rec.game = game;
+            rec.ply = s.ply;
+            rec.seat = s.to_move;
+            rec.num_seats = s.num_seats;
+            records.push_back(rec);
+            s.apply(a);
+        }
+        const Rewards outcome = final_rewards(s);
+        for (SelfPlayRecord& rec : records) {
+            rec.outcome = outcome[rec.seat];
+            if (!ring.push(rec)) return;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const int actors = argc > 1 ? atoi(argv[1]) : static_cast<int>(max(1u, thread::hardware_concurrency() - 1));
+    const int seconds = argc > 2 ? atoi(argv[2]) : 10;
+    const int iterations = argc > 3 ? atoi(argv[3]) : 200;
+    const int seats = argc > 4 ? atoi(argv[4]) : 4;
+    const int learner_ms = argc > 5 ? atoi(argv[5]) : 0;
+    const size_t batch = argc > 6 ? static_cast<size_t>(atoi(argv[6])) : 256;
+
+    try {
+        const string name = "/coup_selfplay_" + to_string(getpid());
+        SelfPlayRing ring(name, 4096);
+        vector<pid_t> children;
+        for (int i = 0; i < actors; ++i) {
+            pid_t pid = fork();
+            if (pid < 0) throw runtime_error("fork failed");
+            if (pid == 0) {
+                int status = 0;
+                try {
+                    run_actor(name, static_cast<uint32_t>(i), iterations, seats);
+                } catch (const exception& e) {
+                    cerr << "actor " << i << ": " << e.what() << endl;
+                    status = 1;
+                }
+                _exit(status);  // leave the learner's ring alone
+            }
+            children.push_back(pid);
+        }
+
+        vector<SelfPlayRecord> buffer(batch);
+        uint64_t received = 0, batches = 0, bad = 0;
+        double outcome_sum = 0;
+        const auto start = chrono::steady_clock::now();
+        const auto stop = start + chrono::seconds(seconds);
+        while (chrono::steady_clock::now() < stop) {
+            const size_t n = ring.pop_batch(buffer.data(), batch);
+            if (n == 0) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+                continue;
+            }
+            // Stand-in for a training step: check and summarize the batch
+            for (size_t i = 0; i < n; ++i) {
+                float total = 0;
+                for (float p : buffer[i].policy) total += p;
+                if (fabs(total - 1) > 1e-3f || buffer[i].obs[0] != 1.0f) ++bad;
+                outcome_sum += buffer[i].outcome;
+            }
+            received += n;
+            ++batches;
+            if (learner_ms > 0) this_thread::sleep_for(chrono::milliseconds(learner_ms));
+        }
+        ring.close();
+        for (pid_t pid : children) waitpid(pid, nullptr, 0);
+        const double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << actors << " actors, " << received << " records in " << batches << " batches ("
+             << static_cast<uint64_t>(static_cast<double>(received) / secs) << "/sec)" << endl;
+        cout << "mean outcome " << (received ? outcome_sum / static_cast<double>(received) : 0)
+             << ", malformed " << bad << ", producer stalls " << ring.stalls()
+             << ", left in ring " << ring.size() << endl;
+        return bad ? 1 : 0;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+}
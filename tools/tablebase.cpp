@@ -0,0 +1,56 @@
+// Email: adhamhamoudy3@gmail.com
+// Builds the two-player endgame tablebase. Rerunning the same command
+// resumes an interrupted build from its last finished pass.
+
+#include "Tablebase.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace coup;
+
+// "all", or comma separated pairs such as Governor:Merchant,Spy:Baron
+static uint64_t parse_pairs(const string& list) {
+    if (list == "all") return ALL_ROLE_PAIRS;
+    uint64_t pairs = 0;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t colon = item.find(':');
+        if (colon == string::npos) throw runtime_error("Expected Role:Role, got " + item);
+        int a = static_cast<int>(role_from_name(item.substr(0, colon)));
+        int b = static_cast<int>(role_from_name(item.substr(colon + 1)));
+        pairs |= 1ULL << (a * NUM_ROLES + b);
+    }
+    return pairs;
+}
+
+// Usage: tablebase_exec <file> [threads] [coin_cap] [pairs]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <file> [threads] [coin_cap] [pairs]" << endl;
+        return 2;
+    }
+    try {
+        TablebaseConfig config;
+        config.threads = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : thread::hardware_concurrency();
+        config.coin_cap = argc > 3 ? atoi(argv[3]) : 16;
+        config.role_pairs = parse_pairs(argc > 4 ? argv[4] : "all");
+
+        auto begin = chrono::steady_clock::now();
+        uint64_t solved = build_tablebase(argv[1], config, &cout);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        Tablebase table(argv[1]);
+        cout << solved << " of " << table.size() << " positions solved in " << secs << " s" << endl;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    return 0;
+}
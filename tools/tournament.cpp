@@ -0,0 +1,90 @@
+// Email: adhamhamoudy3@gmail.com
+// Rates bots against each other: round-robin or Swiss, on all cores.
+
+#include "HeuristicBot.hpp"
+#include "IsmctsBot.hpp"
+#include "MctsBot.hpp"
+#include "Policy.hpp"
+#include "Tournament.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace coup;
+
+static const UniformPolicy UNIFORM;
+
+// greedy, economic, aggressive, uniform, mcts[:iterations], ismcts[:iterations]
+static Entrant entrant(const string& spec) {
+    size_t colon = spec.find(':');
+    string kind = spec.substr(0, colon);
+    int iterations = colon == string::npos ? 1000 : atoi(spec.c_str() + colon + 1);
+    if (kind == "greedy" || kind == "economic" || kind == "aggressive") {
+        HeuristicParams params = kind == "greedy" ? HeuristicParams::greedy()
+                               : kind == "economic" ? HeuristicParams::economic()
+                               : HeuristicParams::aggressive();
+        return {spec, [=](uint64_t seed) { return make_unique<HeuristicBot>(kind, params, seed); }};
+    }
+    if (kind == "uniform") {
+        return {spec, [](uint64_t seed) { return make_unique<PolicyBot>(UNIFORM, seed); }};
+    }
+    if (kind == "mcts" || kind == "ismcts") {
+        return {spec, [=](uint64_t seed) -> unique_ptr<Bot> {
+            MctsConfig config;
+            config.iterations = iterations;
+            config.max_nodes = 1 << 16;
+            config.seed = seed;
+            if (kind == "mcts") return make_unique<MctsBot>(config);
+            return make_unique<IsmctsBot>(config);
+        }};
+    }
+    throw runtime_error("Unknown bot: " + spec);
+}
+
+// Usage: tournament_exec <bot,bot,...> [seats] [deals] [threads] [swiss_rounds] [--replays=DIR]
+int main(int argc, char** argv) {
+    string replay_dir;
+    if (argc > 2 && string(argv[argc - 1]).rfind("--replays=", 0) == 0) {
+        replay_dir = argv[--argc] + strlen("--replays=");
+    }
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <bot,bot,...> [seats] [deals] [threads] [swiss_rounds] [--replays=DIR]"
+             << endl;
+        return 2;
+    }
+    try {
+        vector<Entrant> entrants;
+        stringstream list(argv[1]);
+        for (string spec; getline(list, spec, ',');) entrants.push_back(entrant(spec));
+
+        TournamentConfig config;
+        config.replay_dir = replay_dir;
+        if (!replay_dir.empty()) filesystem::create_directories(replay_dir);
+        if (argc > 2) config.seats = atoi(argv[2]);
+        if (argc > 3) config.deals = atoi(argv[3]);
+        if (argc > 4) config.threads = static_cast<unsigned>(atoi(argv[4]));
+        if (argc > 5) {
+            config.schedule = Schedule::Swiss;
+            config.rounds = atoi(argv[5]);
+        }
+
+        Tournament tournament(entrants, config);
+        auto begin = chrono::steady_clock::now();
+        tournament.run(&cout);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        print_ratings(cout, tournament.table());
+        cout << tournament.games_played() << " games in " << secs << " s ("
+             << static_cast<uint64_t>(tournament.games_played() / secs * 3600) << "/hour)" << endl;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+// Email: adhamhamoudy3@gmail.com
+// Evolves HeuristicParams against the preset bots. Rerunning with the same
+// checkpoint continues the run.
+
+#include "Tuner.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace coup;
+
+// Usage: tune_exec <generations> [threads] [checkpoint] [games] [seats]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <generations> [threads] [checkpoint] [games] [seats]" << endl;
+        return 2;
+    }
+    try {
+        int generations = atoi(argv[1]);
+        TunerConfig config;
+        config.threads = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : thread::hardware_concurrency();
+        config.checkpoint = argc > 3 ? argv[3] : "tuner.ckpt";
+        if (argc > 4) config.games = atoi(argv[4]);
+        if (argc > 5) config.seats = atoi(argv[5]);
+
+        Tuner tuner(config);
+        if (tuner.generation() > 0) cout << "resuming after generation " << tuner.generation() << endl;
+        auto begin = chrono::steady_clock::now();
+        tuner.run(generations, &cout);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        const Candidate& best = tuner.best();
+        HeuristicParams p = from_genes(best.genes);
+        cout << "best (fitness " << best.fitness << "): action_weight =";
+        for (float w : p.action_weight) cout << ' ' << w;
+        cout << ", per_target_coin = " << p.per_target_coin << ", threat_bonus = " << p.threat_bonus
+             << ", per_coin_spent = " << p.per_coin_spent << endl;
+        uint64_t games = static_cast<uint64_t>(generations) * config.population * config.games;
+        cout << games << " games in " << secs << " s (" << static_cast<uint64_t>(games / secs) << "/sec)" << endl;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Email: adhamhamoudy3@gmail.com
+// Re-simulates a directory of replays on all cores and reports every file
+// whose final state hash no longer matches its footer, e.g. after a rules
+// or engine change. Exits 1 if any file fails.
+
+#include "ReplayCorpus.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace coup;
+
+// Usage: verify_exec <dir> [threads] [--any-rules]
+int main(int argc, char** argv) {
+    CorpusConfig config;
+    if (argc > 2 && strcmp(argv[argc - 1], "--any-rules") == 0) {
+        config.any_rules = true;
+        --argc;
+    }
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <dir> [threads] [--any-rules]" << endl;
+        return 2;
+    }
+    if (argc > 2) config.threads = static_cast<unsigned>(atoi(argv[2]));
+    try {
+        auto begin = chrono::steady_clock::now();
+        CorpusReport report = verify_corpus(argv[1], config);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        for (const CorpusProblem& p : report.problems) cout << p.path << ": " << p.what << endl;
+        const uint64_t shown = report.problems.size();
+        if (report.mismatches + report.errors > shown) {
+            cout << "(" << report.mismatches + report.errors - shown << " more not shown)" << endl;
+        }
+        cout << report.files << " replays, " << report.actions << " actions in " << secs << " s ("
+             << static_cast<uint64_t>(report.files / secs) << " replays/sec, "
+             << static_cast<uint64_t>(report.actions / secs) << " actions/sec)" << endl;
+        cout << report.mismatches << " hash mismatches, " << report.errors << " errors" << endl;
+        return report.ok() ? 0 : 1;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+}